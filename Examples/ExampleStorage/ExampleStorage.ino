@@ -37,6 +37,8 @@ void setup()
 	Serial.println();
 	Serial.println(F("Example Storage Test Start"));
 
+	EmbeddedStorage.Begin();
+
 	uint32_t duration = micros();
 
 	if (EmbeddedStorage.ReadData((uint8_t*)&TestData))
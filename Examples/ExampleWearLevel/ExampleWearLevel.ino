@@ -56,6 +56,9 @@ void setup()
 	Serial.println();
 	Serial.println(F("Example Wear Level Storage Test Start"));
 
+	EmbeddedStorage.Begin();
+	EmbeddedStorage2.Begin();
+
 
 	Serial.println(F("EEPROM"));
 	Serial.println(F("Used\tFree\tTotal"));
@@ -0,0 +1,66 @@
+/*
+	Flash Size Report.
+	Instantiates SIZE_REPORT_UNIT_COUNT distinct StorageUnit and TinyWearLevelUnit pairs.
+	Each pair has a different address, size and key.
+
+	Build once with SIZE_REPORT_UNIT_COUNT 1 and once with 8, then compare the reported program size:
+		(Size8 - Size1) / 7 = flash cost of each added unit pair.
+	Units share a single non-templated StorageEngine, so the added cost is only the typed facade calls.
+*/
+
+#define SERIAL_BAUD_RATE 9600
+
+#if !defined(SIZE_REPORT_UNIT_COUNT)
+#define SIZE_REPORT_UNIT_COUNT 8
+#endif
+
+#include <StorageUnit.h>
+#include <WearLevelUnit.h>
+
+template<const uint8_t Index>
+struct UnitPair
+{
+	using Unit = StorageUnit<Index * 16, 4 + Index, 100 + Index>;
+	using WearUnit = TinyWearLevelUnit<160 + (Index * 24), 2 + Index, WearLevelTiny::x2>;
+
+	static const uint8_t Exercise(uint8_t* buffer)
+	{
+		Unit unit{};
+		WearUnit wearUnit{};
+
+		unit.Begin();
+		wearUnit.Begin();
+		unit.WriteData(buffer);
+		wearUnit.WriteData(buffer);
+
+		return unit.ReadData(buffer) + wearUnit.ReadData(buffer) + UnitPair<Index - 1>::Exercise(buffer);
+	}
+};
+
+template<>
+struct UnitPair<0>
+{
+	static const uint8_t Exercise(uint8_t* buffer)
+	{
+		return 0;
+	}
+};
+
+uint8_t Buffer[16]{};
+
+void setup()
+{
+	Serial.begin(SERIAL_BAUD_RATE);
+
+	for (uint8_t i = 0; i < sizeof(Buffer); i++)
+	{
+		Buffer[i] = random(UINT8_MAX);
+	}
+
+	Serial.print(F("Units validated: "));
+	Serial.println(UnitPair<SIZE_REPORT_UNIT_COUNT>::Exercise(Buffer));
+}
+
+void loop()
+{
+}
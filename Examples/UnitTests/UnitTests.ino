@@ -6,11 +6,28 @@
 
 #define EEPROM_BOUNDS_CHECK
 #define WEAR_LEVEL_DEBUG
+//#define EEPROM_TRACE
+//#define EEPROM_TRACE_SIZE 8
 //#define EEPROM_MOCK_IN_MEMORY
 
 #include <StorageUnit.h>
 #include <WearLevelUnit.h>
 #include <StorageAttributor.h>
+#include <CompressedUnit.h>
+#include <ChunkedUnit.h>
+#include <BusInvertUnit.h>
+#include <CounterUnit.h>
+#include <LogUnit.h>
+#include <StorageDispatcher.h>
+#include <StorageImage.h>
+#include <DeferredWriteQueue.h>
+#include <StoragePlanner.h>
+#include <StripedStorage.h>
+#include <LockedUnit.h>
+#include <StorageScrubber.h>
+#include <DefaultedUnit.h>
+#include <PackedUnit.h>
+#include <WearPool.h>
 
 struct Storage1Definition
 {
@@ -53,8 +70,12 @@ struct Storage3Definition
 
 using StructsSizeAttributor = TemplateSizeAttributor<Storage1Definition::EeepromSize, Storage2Definition::EeepromSize, Storage3Definition::EeepromSize>;
 using StructsAttributor = TemplateStorageAttributor<Storage1Definition, Storage2Definition, Storage3Definition>;
+using ReverseStructsAttributor = TemplateStorageAttributor<Storage3Definition, Storage2Definition, Storage1Definition>;
+using ReverseStructsDispatcher = TemplateStorageDispatcher<Storage3Definition, Storage2Definition, Storage1Definition>;
+using ReverseStructsScrubber = TemplateStorageScrubber<Storage3Definition, Storage2Definition, Storage1Definition>;
 
 using TestUnitStorage = StorageUnit<0, sizeof(Storage1Definition::Struct)>;
+using TestUnitLastStorage = StorageUnit<EmbeddedEEPROM::Size() - 2, sizeof(uint8_t)>;
 using TestUnitTiny5 = TinyWearLevelUnit<TestUnitStorage::Address() + TestUnitStorage::Size(), sizeof(Storage2Definition::Struct), Storage2Definition::WearLevelOption>;
 using TestUnitShort10 = ShortWearLevelUnit<TestUnitTiny5::Address() + TestUnitTiny5::Size(), sizeof(Storage3Definition::Struct), Storage3Definition::WearLevelOption>;
 static constexpr size_t InlineUsed = TestUnitShort10::Address() + TestUnitShort10::Size();
@@ -64,6 +85,222 @@ using TestUnitLong18 = LongWearLevelUnit<0, sizeof(uint8_t), WearLevelLong::x18>
 using TestUnitLong33 = LongWearLevelUnit<0, sizeof(uint8_t), WearLevelLong::x33>;
 using TestUnitLongLong34 = LongLongWearLevelUnit<0, sizeof(uint8_t), WearLevelLongLong::x34>;
 using TestUnitLongLong65 = LongLongWearLevelUnit<0, sizeof(uint8_t), WearLevelLongLong::x65>;
+static constexpr uint32_t TornRolloverKey = 10045;
+using TestUnitTornRollover = ShortWearLevelUnit<0, sizeof(uint16_t), WearLevelShort::x10, TornRolloverKey>;
+
+static constexpr uint16_t CompressedTestSize = 120;
+using TestUnitCompressed = CompressedStorageUnit<0, CompressedTestSize>;
+using TestUnitCompressedTiny3 = CompressedWearLevelUnit<TinyWearLevelUnit<0, DeltaRleCodec::GetSlotSize(CompressedTestSize), WearLevelTiny::x3>, CompressedTestSize>;
+
+using TestUnitLog = LogUnit<0, sizeof(uint32_t), 7>;
+
+using TestUnitBusInvert = BusInvertStorageUnit<0, sizeof(uint32_t)>;
+using TestUnitBusPlain = StorageUnit<0, sizeof(uint32_t)>;
+
+using TestUnitCounter = CounterUnit<0, 2>;
+
+// Counts lock calls, to check every exposed member takes the lock.
+struct TestCountingLockPolicy
+{
+	uint8_t Locks = 0;
+	uint8_t Unlocks = 0;
+
+	void Lock()
+	{
+		Locks++;
+	}
+
+	void Unlock()
+	{
+		Unlocks++;
+	}
+};
+
+using TestUnitLockedInner = TinyWearLevelUnit<0, sizeof(uint16_t), WearLevelTiny::x3>;
+using TestUnitLocked = LockedUnit<TestUnitLockedInner, TestCountingLockPolicy>;
+using TestUnitLockedCommitted = LockedUnit<TestUnitLockedInner, TestCountingLockPolicy, LockedRead::Committed>;
+
+const uint32_t TestDefaultValue PROGMEM = 0x12345678;
+using TestUnitDefaulted = DefaultedUnit<StorageUnit<0, sizeof(uint32_t)>, uint32_t, TestDefaultValue>;
+using TestUnitDefaultedTiny3 = DefaultedUnit<TinyWearLevelUnit<0, sizeof(uint32_t), WearLevelTiny::x3>, uint32_t, TestDefaultValue>;
+
+enum class TestPackedMode : uint8_t
+{
+	Off,
+	Eco,
+	Normal,
+	Boost,
+	Service
+};
+
+struct TestPackedStruct
+{
+	bool Enabled;
+	TestPackedMode Mode;
+	uint16_t Adc;
+	int8_t Temperature;
+	uint32_t Runtime;
+};
+
+using TestPackedSchema = PackedSchema<TestPackedStruct,
+	PACKED_MEMBER(TestPackedStruct, Enabled, 1),
+	PACKED_MEMBER(TestPackedStruct, Mode, 3),
+	PACKED_MEMBER(TestPackedStruct, Adc, 10),
+	PACKED_RANGE(TestPackedStruct, Temperature, -40, 85),
+	PACKED_MEMBER(TestPackedStruct, Runtime, 20)>;
+
+using TestPackedSchemaWider = PackedSchema<TestPackedStruct,
+	PACKED_MEMBER(TestPackedStruct, Enabled, 1),
+	PACKED_MEMBER(TestPackedStruct, Mode, 3),
+	PACKED_MEMBER(TestPackedStruct, Adc, 12),
+	PACKED_RANGE(TestPackedStruct, Temperature, -40, 85),
+	PACKED_MEMBER(TestPackedStruct, Runtime, 20)>;
+
+static_assert(TestPackedSchema::Bits == 41 && TestPackedSchema::Size == 6, "PackedSchema size failed.");
+static_assert(TestPackedSchema::Key != TestPackedSchemaWider::Key, "PackedSchema Key must change with the schema.");
+
+using TestUnitPackedStorage = PackedStorageUnit<0, TestPackedSchema>;
+using TestUnitPacked = PackedTinyWearLevelUnit<0, TestPackedSchema, WearLevelTiny::x3>;
+
+using TestPool = TemplateWearPool<StructsAttributor, DeviceProfileATtiny85, sizeof(uint32_t), 3>;
+
+static constexpr uint16_t ChunkedTestSize = 50;
+static constexpr uint8_t ChunkedTestChunkSize = 8;
+using TestUnitChunked = ChunkedStorageUnit<0, ChunkedTestSize, ChunkedTestChunkSize>;
+
+static constexpr uint16_t EccTestSize = 20;
+using TestUnitEcc = StorageUnit<0, EccTestSize, EccTestSize, ErrorCorrection::Secded>;
+using TestUnitEccTiny3 = TinyWearLevelUnit<0, EccTestSize, WearLevelTiny::x3, EccTestSize, ErrorCorrection::Secded>;
+
+using TestDeferredUnit0 = StorageUnit<0, sizeof(uint16_t)>;
+using TestDeferredUnit1 = TinyWearLevelUnit<TestDeferredUnit0::Address() + TestDeferredUnit0::Size(), sizeof(uint16_t), WearLevelTiny::x4>;
+using TestDeferredQueue = DeferredWriteQueue<2, sizeof(uint16_t)>;
+
+// 10 years, at 10, 100 and 1000 writes per day.
+using PlannedRareDefinition = PlannedDefinition<DeviceProfileATmega328P, uint16_t, 200001, 10, 3650>;
+using PlannedHourlyDefinition = PlannedDefinition<DeviceProfileATmega328P, uint16_t, 200002, 100, 3650>;
+using PlannedFrequentDefinition = PlannedDefinition<DeviceProfileATmega328P, uint16_t, 200003, 1000, 3650>;
+using PlannedFramDefinition = PlannedDefinition<DeviceProfileFM24V10, uint16_t, 200004, 100000, 3650>;
+using PlannedAttributor = TemplateDeviceAttributor<DeviceProfileATmega328P, PlannedRareDefinition, PlannedHourlyDefinition, PlannedFrequentDefinition>;
+using TestUnitPlanned = PlannedHourlyDefinition::Unit<0>;
+
+static constexpr uint16_t TimingTestSize = 8;
+using TestTimingStorage = StorageUnit<0, TimingTestSize>;
+using TestTimingTiny4 = TinyWearLevelUnit<0, TimingTestSize, WearLevelTiny::x4>;
+using TestTimingShort10 = ShortWearLevelUnit<0, TimingTestSize, WearLevelShort::x10>;
+using TestTimingLong18 = LongWearLevelUnit<0, TimingTestSize, WearLevelLong::x18>;
+using TestTimingLongLong34 = LongLongWearLevelUnit<0, TimingTestSize, WearLevelLongLong::x34>;
+
+#if defined(EEPROM_MOCK_IN_MEMORY)
+/// <summary>
+/// Small device, for independent mock device instances.
+/// </summary>
+struct DeviceProfileTest
+{
+	static constexpr uint32_t Capacity = 64;
+
+	static constexpr uint16_t ReadMicros = 1;
+	static constexpr uint16_t EraseWriteMicros = 10;
+	static constexpr uint16_t EraseMicros = 5;
+	static constexpr uint16_t WriteMicros = 5;
+};
+
+/// <summary>
+/// Small external EEPROM, with 24LC256 timings, for striping simulation.
+/// </summary>
+struct DeviceProfileStripeTest
+{
+	static constexpr uint32_t Capacity = 64;
+	static constexpr uint16_t EraseGranularity = DeviceProfile24LC256::EraseGranularity;
+
+	static constexpr uint16_t ReadMicros = DeviceProfile24LC256::ReadMicros;
+	static constexpr uint16_t EraseWriteMicros = DeviceProfile24LC256::EraseWriteMicros;
+	static constexpr uint16_t EraseMicros = DeviceProfile24LC256::EraseMicros;
+	static constexpr uint16_t WriteMicros = DeviceProfile24LC256::WriteMicros;
+};
+
+template<const uint32_t key>
+struct StripeTestDefinition
+{
+	static constexpr uint16_t Size = 8;
+	static constexpr uint32_t Key = key;
+	static constexpr NoWearLevel WearLevelOption = NoWearLevel::x1;
+};
+
+using StripeDefinition0 = StripeTestDefinition<300001>;
+using StripeDefinition1 = StripeTestDefinition<300002>;
+using StripeDefinition2 = StripeTestDefinition<300003>;
+using StripeDefinition3 = StripeTestDefinition<300004>;
+
+// All units on a single device.
+using SingleStripeLayout = TemplateDeviceAttributor<DeviceProfileStripeTest, StripeDefinition0, StripeDefinition1, StripeDefinition2, StripeDefinition3>;
+using TestUnitSingle0 = StripedStorageUnit<0, SingleStripeLayout::GetAddressByKey(StripeDefinition0::Key), StripeDefinition0::Size, StripeDefinition0::Key>;
+using TestUnitSingle1 = StripedStorageUnit<0, SingleStripeLayout::GetAddressByKey(StripeDefinition1::Key), StripeDefinition1::Size, StripeDefinition1::Key>;
+using TestUnitSingle2 = StripedStorageUnit<0, SingleStripeLayout::GetAddressByKey(StripeDefinition2::Key), StripeDefinition2::Size, StripeDefinition2::Key>;
+using TestUnitSingle3 = StripedStorageUnit<0, SingleStripeLayout::GetAddressByKey(StripeDefinition3::Key), StripeDefinition3::Size, StripeDefinition3::Key>;
+
+// Two units per device, on two devices.
+using StripeLayout0 = TemplateDeviceAttributor<DeviceProfileStripeTest, StripeDefinition0, StripeDefinition2>;
+using StripeLayout1 = TemplateDeviceAttributor<DeviceProfileStripeTest, StripeDefinition1, StripeDefinition3>;
+using TestUnitStriped0 = StripedStorageUnit<0, StripeLayout0::GetAddressByKey(StripeDefinition0::Key), StripeDefinition0::Size, StripeDefinition0::Key>;
+using TestUnitStriped1 = StripedStorageUnit<1, StripeLayout1::GetAddressByKey(StripeDefinition1::Key), StripeDefinition1::Size, StripeDefinition1::Key>;
+using TestUnitStriped2 = StripedStorageUnit<0, StripeLayout0::GetAddressByKey(StripeDefinition2::Key), StripeDefinition2::Size, StripeDefinition2::Key>;
+using TestUnitStriped3 = StripedStorageUnit<1, StripeLayout1::GetAddressByKey(StripeDefinition3::Key), StripeDefinition3::Size, StripeDefinition3::Key>;
+
+// One unit per device, on four devices.
+using TestUnitQuad0 = StripedStorageUnit<0, 0, StripeDefinition0::Size, StripeDefinition0::Key>;
+using TestUnitQuad1 = StripedStorageUnit<1, 0, StripeDefinition1::Size, StripeDefinition1::Key>;
+using TestUnitQuad2 = StripedStorageUnit<2, 0, StripeDefinition2::Size, StripeDefinition2::Key>;
+using TestUnitQuad3 = StripedStorageUnit<3, 0, StripeDefinition3::Size, StripeDefinition3::Key>;
+#endif
+
+// Units are stateless, with no RAM cost per instance. Only LogUnit keeps its head and tail in RAM.
+static_assert(sizeof(TestUnitStorage) == 1, "StorageUnit must be stateless.");
+static_assert(sizeof(TestUnitEcc) == 1, "StorageUnit must be stateless.");
+static_assert(sizeof(TestUnitTiny5) == 1, "TinyWearLevelUnit must be stateless.");
+static_assert(sizeof(TestUnitShort10) == 1, "ShortWearLevelUnit must be stateless.");
+static_assert(sizeof(TestUnitLong33) == 1, "LongWearLevelUnit must be stateless.");
+static_assert(sizeof(TestUnitLongLong65) == 1, "LongLongWearLevelUnit must be stateless.");
+static_assert(sizeof(TestUnitEccTiny3) == 1, "TinyWearLevelUnit must be stateless.");
+static_assert(sizeof(TestUnitPlanned) == 1, "Planned unit must be stateless.");
+static_assert(sizeof(TestUnitCompressed) == 1, "CompressedStorageUnit must be stateless.");
+static_assert(sizeof(TestUnitCompressedTiny3) == 1, "CompressedWearLevelUnit must be stateless.");
+static_assert(sizeof(TestUnitChunked) == 1, "ChunkedStorageUnit must be stateless.");
+static_assert(sizeof(TestUnitBusInvert) == 1, "BusInvertStorageUnit must be stateless.");
+static_assert(sizeof(TestUnitCounter) == 1, "CounterUnit must be stateless.");
+static_assert(sizeof(TestUnitLockedCommitted) == 1, "LockedUnit must be stateless.");
+static_assert(sizeof(TestUnitDefaultedTiny3) == 1, "DefaultedUnit must be stateless.");
+static_assert(sizeof(TestUnitPacked) == 1, "PackedUnit must be stateless.");
+static_assert(sizeof(StripedStorageUnit<0, 0, sizeof(uint32_t)>) == 1, "StripedStorageUnit must be stateless.");
+
+/// <summary>
+/// In-memory Stream, for image export/import testing.
+/// </summary>
+class LoopbackStream : public Stream
+{
+private:
+	uint8_t Buffer[128]{};
+	uint16_t WriteIndex = 0;
+	uint16_t ReadIndex = 0;
+
+public:
+	int available() { return WriteIndex - ReadIndex; }
+	int peek() { return (ReadIndex < WriteIndex) ? Buffer[ReadIndex] : -1; }
+	int read() { return (ReadIndex < WriteIndex) ? Buffer[ReadIndex++] : -1; }
+	size_t write(uint8_t value)
+	{
+		if (WriteIndex < sizeof(Buffer))
+		{
+			Buffer[WriteIndex++] = value;
+			return 1;
+		}
+		return 0;
+	}
+	using Print::write;
+
+	void Rewind() { ReadIndex = 0; }
+	void Corrupt(const uint16_t index) { Buffer[index] ^= 1; }
+};
 
 
 void loop()
@@ -120,12 +357,19 @@ void setup()
 	}
 
 	TestStorageAttributor();
+#if !defined(ARDUINO_AVR_ATTINYX5)
+	TestStorageDispatcher();
+	TestStorageImage();
+	TestStoragePlanner();
+#endif
 	Serial.println();
 
 	TestStorageUnit<TestUnitStorage>();
+	TestStorageUnit<TestUnitLastStorage>();
 #if defined(ARDUINO_AVR_ATTINYX5)
 	TestUnitWear<TestUnitTiny5>("Tiny2");
 	TestUnitWear<TestUnitShort10>("Short10");
+	TestUnitWear<TestUnitPlanned>("Planned4");
 #else
 	TestUnitWear<TestUnitTiny5>("Tiny2");
 	TestUnitWear<TestUnitShort10>("Short10");
@@ -134,6 +378,40 @@ void setup()
 	TestUnitWear<TestUnitLong33>("Long33");
 	TestUnitWear<TestUnitLongLong34>("LongLong34");
 	TestUnitWear<TestUnitLongLong65>("LongLong65");
+	TestUnitWear<TestUnitPlanned>("Planned4");
+#endif
+	TestChunkedUnit<TestUnitChunked>();
+	TestBusInvert<TestUnitBusInvert, TestUnitBusPlain>();
+	TestCounterUnit<TestUnitCounter>();
+	TestLockedUnit<TestUnitLocked, TestUnitLockedCommitted>();
+	TestDefaultedUnit<TestUnitDefaulted>("Storage");
+	TestDefaultedUnit<TestUnitDefaultedTiny3>("Tiny3");
+#if !defined(ARDUINO_AVR_ATTINYX5)
+	TestCompressedUnit<TestUnitCompressed>("Storage");
+	TestCompressedUnit<TestUnitCompressedTiny3>("Tiny3");
+	TestLogUnit<TestUnitLog>();
+	TestPackedUnit<TestUnitPackedStorage>();
+	TestPackedUnit<TestUnitPacked>();
+	TestWearPool();
+	TestStorageScrubber();
+	TestErrorCorrection<TestUnitEcc, TestUnitEccTiny3>();
+	TestVersionHistory<TestUnitTiny5>();
+	TestTornRollover<TestUnitTornRollover>();
+	TestDeferredWriteQueue();
+#endif
+#if defined(EEPROM_TRACE)
+	TestEepromTrace();
+#endif
+#if defined(EEPROM_MOCK_IN_MEMORY)
+	TestWriteLatency<TestTimingStorage>("Storage", 0, 1);
+	TestWriteLatency<TestTimingTiny4>("Tiny4", 1, 4);
+	TestWriteLatency<TestTimingShort10>("Short10", 2, 10);
+	TestWriteLatency<TestTimingLong18>("Long18", 4, 18);
+	TestWriteLatency<TestTimingLongLong34>("LongLong34", 8, 34);
+	TestMockDevices();
+#if !defined(ARDUINO_AVR_ATTINYX5)
+	TestStripedStorage();
+#endif
 #endif
 
 	Serial.println();
@@ -263,6 +541,198 @@ void TestStorageAttributor()
 	Serial.println();
 }
 
+void TestStorageDispatcher()
+{
+	Serial.println(F("\tDispatch Table"));
+
+	EmbeddedEEPROM::EraseEEPROM();
+
+	// First boot validates all units, the next one skips on the stored fingerprint.
+	if (ReverseStructsDispatcher::Begin()
+		|| !ReverseStructsDispatcher::Begin()
+		|| ReverseStructsDispatcher::GetUsed() != (ReverseStructsAttributor::GetUsed() + EmbeddedStorage::GetStorageSize(sizeof(uint32_t))))
+	{
+		Serial.println(F("Dispatcher Begin() failed."));
+		OnFail();
+	}
+
+	const uint32_t keys[] = { Storage1Definition::Key, Storage2Definition::Key, Storage3Definition::Key };
+	StorageEntry entry;
+	uint32_t value = 0;
+
+	for (uint8_t i = 0; i < ReverseStructsDispatcher::GetCount(); i++)
+	{
+		if (!ReverseStructsDispatcher::Find(keys[i], entry)
+			|| entry.Key != keys[i])
+		{
+			Serial.print(F("Dispatcher Find() failed: "));
+			Serial.println(keys[i]);
+			OnFail();
+		}
+
+		PrintStorage(i, entry.Address, entry.Size);
+
+		if (entry.Address != ReverseStructsAttributor::GetAddressByKey(keys[i]))
+		{
+			PrintAddressMismatch(i, entry.Address, ReverseStructsAttributor::GetAddressByKey(keys[i]), 3);
+			OnFail();
+		}
+
+		value = keys[i];
+		if (!ReverseStructsDispatcher::WriteByKey(keys[i], (uint8_t*)&value))
+		{
+			Serial.println(F("Dispatcher WriteByKey() failed."));
+			OnFail();
+		}
+	}
+
+	for (uint8_t i = 0; i < ReverseStructsDispatcher::GetCount(); i++)
+	{
+		value = 0;
+		ReverseStructsDispatcher::Find(keys[i], entry);
+		if (!ReverseStructsDispatcher::ReadByKey(keys[i], (uint8_t*)&value)
+			|| memcmp(&value, &keys[i], entry.Size) != 0)
+		{
+			Serial.println(F("Dispatcher ReadByKey() failed."));
+			OnFail();
+		}
+	}
+
+	if (ReverseStructsDispatcher::Find(0, entry)
+		|| ReverseStructsDispatcher::ReadByKey(UINT32_MAX, (uint8_t*)&value))
+	{
+		Serial.println(F("Dispatcher unknown key failed."));
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+void TestStoragePlanner()
+{
+	Serial.println(F("\tEndurance Planner"));
+
+	if (PlannedRareDefinition::Levels != 1
+		|| PlannedHourlyDefinition::Levels != 4
+		|| PlannedFrequentDefinition::Levels != 37
+		|| PlannedFramDefinition::Levels != 1)
+	{
+		Serial.println(F("Planner GetLevels() failed."));
+		OnFail();
+	}
+
+	if (StoragePlanner<DeviceProfile24LC256>::IsPlannable(1000, 3650)
+		|| !StoragePlanner<DeviceProfile24LC256>::IsPlannable(100, 3650)
+		|| StoragePlanner<DeviceProfileATmega328P>::IsPlannable(10000, 3650))
+	{
+		Serial.println(F("Planner IsPlannable() failed."));
+		OnFail();
+	}
+
+	if (StoragePlanner<DeviceProfileATmega328P>::GetLifetimeDays(100, (uint8_t)PlannedHourlyDefinition::WearLevelOption) < 3650)
+	{
+		Serial.println(F("Planner GetLifetimeDays() failed."));
+		OnFail();
+	}
+
+	if (!PlannedAttributor::FitsDevice<DeviceProfileATtiny85>()
+		|| PlannedAttributor::GetUsed() != (EmbeddedStorage::GetStorageSize(sizeof(uint16_t))
+			+ EmbeddedStorage::GetStorageSize(sizeof(uint16_t), WearLevelTiny::x4)
+			+ EmbeddedStorage::GetStorageSize(sizeof(uint16_t), WearLevelLongLong::x37)))
+	{
+		Serial.println(F("Planner attribution failed."));
+		OnFail();
+	}
+
+	Serial.print(F("\tPlanned "));
+	Serial.print(PlannedAttributor::GetUsed());
+	Serial.println(F(" bytes."));
+	Serial.println(F("\tValidated."));
+}
+
+void TestStorageImage()
+{
+	Serial.println(F("\tStorage Image"));
+
+	if (StructsAttributor::GetFingerprint() == ReverseStructsAttributor::GetFingerprint())
+	{
+		Serial.println(F("Attributor GetFingerprint() failed."));
+		OnFail();
+	}
+
+	uint8_t original[StructsAttributor::GetUsed()];
+	for (uint16_t i = 0; i < StructsAttributor::GetUsed(); i++)
+	{
+		original[i] = random(UINT8_MAX);
+		EmbeddedEEPROM::WriteBlock(i, original[i]);
+	}
+
+	LoopbackStream stream{};
+	StorageImage<StructsAttributor>::Export(stream);
+	if ((StorageAddress)stream.available() != StorageImage<StructsAttributor>::GetImageSize())
+	{
+		Serial.println(F("Image Export() failed."));
+		OnFail();
+	}
+
+	EmbeddedEEPROM::EraseEEPROM();
+	if (StorageImage<ReverseStructsAttributor>::Import(stream) != ImageResult::LayoutMismatch)
+	{
+		Serial.println(F("Image Import() layout failed."));
+		OnFail();
+	}
+
+	stream.Rewind();
+	if (StorageImage<StructsAttributor>::Import(stream) != ImageResult::Success)
+	{
+		Serial.println(F("Image Import() failed."));
+		OnFail();
+	}
+
+	for (uint16_t i = 0; i < StructsAttributor::GetUsed(); i++)
+	{
+		if (EmbeddedEEPROM::ReadBlock(i) != original[i])
+		{
+			Serial.println(F("Image Import() data failed."));
+			OnFail();
+		}
+	}
+
+	stream.Rewind();
+	stream.Corrupt(StorageImage<StructsAttributor>::GetImageSize() - 1);
+	if (StorageImage<StructsAttributor>::Import(stream) != ImageResult::ChecksumMismatch)
+	{
+		Serial.println(F("Image Import() checksum failed."));
+		OnFail();
+	}
+	stream.Corrupt(StorageImage<StructsAttributor>::GetImageSize() - 1);
+
+	// A corrupted chunk is refused before any of its bytes are programmed.
+	// Header is ||Magic|Fingerprint|Size|Checksum||, the first chunk follows.
+	const uint8_t headerSize = sizeof(uint16_t) + sizeof(uint32_t) + sizeof(StorageAddress) + sizeof(uint16_t);
+	EmbeddedEEPROM::EraseEEPROM();
+	stream.Rewind();
+	stream.Corrupt(headerSize);
+	if (StorageImage<StructsAttributor>::Import(stream) != ImageResult::ChecksumMismatch
+		|| EmbeddedEEPROM::ReadBlock(0) != UINT8_MAX)
+	{
+		Serial.println(F("Image Import() chunk checksum failed."));
+		OnFail();
+	}
+	stream.Corrupt(headerSize);
+
+	// Resumes by importing the same image again.
+	stream.Rewind();
+	if (StorageImage<StructsAttributor>::Import(stream) != ImageResult::Success
+		|| EmbeddedEEPROM::ReadBlock(0) != original[0])
+	{
+		Serial.println(F("Image Import() resume failed."));
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
 void PrintAddressMismatch(const uint8_t index, const uint16_t address, const uint16_t expected, const uint8_t errorCode)
 {
 	Serial.print(F("Storage"));
@@ -291,6 +761,7 @@ template<typename StorageType>
 void TestStorageUnit()
 {
 	StorageType storage{};
+	storage.Begin();
 	Serial.print(F("Testing Storage Unit\t"));
 	Serial.print(StorageType::Address());
 	Serial.print(',');
@@ -334,6 +805,7 @@ template<class UnitType>
 void TestUnitWear(String name)
 {
 	UnitType unit{};
+	unit.Begin();
 
 	const uint8_t option = unit.DebugOption();
 	Serial.print(F("Testing Wear Level "));
@@ -378,13 +850,14 @@ void TestUnitWear(String name)
 		OnFail();
 	}
 
+	// Held wider than the units' data so multi-byte units stay in bounds.
 	const uint8_t testValue = 123;
-	uint8_t value = 0;
+	uint32_t value = 0;
 
 	for (uint8_t i = 0; i < option; i++)
 	{
 		value = testValue + i;
-		unit.WriteData(&value);
+		unit.WriteData((uint8_t*)&value);
 		Serial.print(F("\t"));
 		Serial.print(F("\t"));
 		Serial.print(i);
@@ -401,7 +874,7 @@ void TestUnitWear(String name)
 		}
 
 		value = 0;
-		if (!unit.ReadData(&value) || value != (testValue + i))
+		if (!unit.ReadData((uint8_t*)&value) || value != (uint32_t)(testValue + i))
 		{
 			Serial.println(F("\tReadback invalidated."));
 			OnFail();
@@ -409,7 +882,7 @@ void TestUnitWear(String name)
 	}
 
 	// One more write to force to counter to cycle back to zero.
-	unit.WriteData(&value);
+	unit.WriteData((uint8_t*)&value);
 	Serial.print(F("\tEnd"));
 	PrintWearMask<UnitType>(unit.GetCounterSize(), unit);
 	if (unit.DebugCounter() != 0)
@@ -421,3 +894,1279 @@ void TestUnitWear(String name)
 
 	Serial.println(F("\tValidated."));
 }
+
+template<class UnitType>
+void TestCompressedUnit(String name)
+{
+	UnitType unit{};
+	uint8_t table[CompressedTestSize]{};
+	uint8_t value[CompressedTestSize]{};
+	unit.Begin();
+
+	Serial.print(F("Testing Compressed "));
+	Serial.print(name);
+	Serial.print(F(" Unit\t"));
+	Serial.print(UnitType::Address());
+	Serial.print(',');
+	Serial.println(UnitType::Size());
+
+	EmbeddedEEPROM::EraseEEPROM();
+
+	for (uint8_t pass = 0; pass < 4; pass++)
+	{
+		// Zero run, slow ramp and noise.
+		for (uint16_t i = 0; i < CompressedTestSize; i++)
+		{
+			if (i < 40)
+			{
+				table[i] = 0;
+			}
+			else if (i < 100)
+			{
+				table[i] = pass + (i / 4);
+			}
+			else
+			{
+				table[i] = random(UINT8_MAX);
+			}
+		}
+
+		unit.WriteData(table);
+		if (!unit.ReadData(value)
+			|| memcmp(table, value, CompressedTestSize) != 0)
+		{
+			Serial.println(F("\tReadback invalidated."));
+			OnFail();
+		}
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+template<class UnitType>
+void TestLogUnit()
+{
+	Serial.print(F("Testing Log Unit\t"));
+	Serial.print(UnitType::Address());
+	Serial.print(',');
+	Serial.println(UnitType::Size());
+
+	EmbeddedEEPROM::EraseEEPROM();
+
+	const uint16_t capacity = UnitType::GetCapacity();
+	uint16_t expectedPending = 0;
+	uint32_t value = 0;
+
+	for (uint16_t appends = 1; appends <= (capacity * 3); appends++)
+	{
+		{
+			UnitType unit{};
+			unit.Begin();
+			value = appends;
+			unit.Append((uint8_t*)&value);
+			expectedPending = min((uint16_t)(expectedPending + 1), capacity);
+
+			// Acknowledge every other record.
+			if ((appends % 2) == 0)
+			{
+				unit.Consume();
+				expectedPending--;
+			}
+		}
+
+		// Reload, as if after reset.
+		UnitType unit{};
+		unit.Begin();
+		const uint16_t expectedCount = min(appends, capacity);
+		if (unit.GetCount() != expectedCount)
+		{
+			Serial.print(F("\tCount invalidated: "));
+			Serial.println(unit.GetCount());
+			OnFail();
+		}
+
+		for (uint16_t age = 0; age < unit.GetCount(); age++)
+		{
+			if (!unit.ReadRecord(age, (uint8_t*)&value)
+				|| value != (uint32_t)(appends - age))
+			{
+				Serial.print(F("\tRecord invalidated at age "));
+				Serial.println(age);
+				OnFail();
+			}
+		}
+
+		if (unit.GetPendingCount() != expectedPending)
+		{
+			Serial.print(F("\tPending invalidated: "));
+			Serial.println(unit.GetPendingCount());
+			OnFail();
+		}
+	}
+
+	// Drain the queue, oldest first.
+	UnitType unit{};
+	unit.Begin();
+	uint32_t previous = 0;
+	while (unit.Peek((uint8_t*)&value))
+	{
+		if (value <= previous)
+		{
+			Serial.println(F("\tQueue order invalidated."));
+			OnFail();
+		}
+		previous = value;
+		unit.Consume();
+	}
+
+	if (UnitType().GetPendingCount() != 0)
+	{
+		Serial.println(F("\tQueue drain invalidated."));
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+/// <summary>
+/// Workload value for write index.
+/// </summary>
+/// <param name="workload">0 toggles between two values, 1 counts up, 2 is pseudo-random.</param>
+const uint32_t GetBusInvertValue(const uint8_t workload, const uint16_t index)
+{
+	switch (workload)
+	{
+	case 0:
+		return (index & 1) ? 0x5A0FF0A5 : 0xA5F00F5A;
+	case 1:
+		return index;
+	default:
+		return (uint32_t)index * 2654435761UL;
+	}
+}
+
+template<class UnitType, class PlainUnitType>
+void TestBusInvert()
+{
+	UnitType unit{};
+	PlainUnitType plainUnit{};
+	uint32_t value = 0;
+	unit.Begin();
+	plainUnit.Begin();
+
+	Serial.print(F("Testing Bus Invert Unit\t"));
+	Serial.print(UnitType::Address());
+	Serial.print(',');
+	Serial.println(UnitType::Size());
+
+	for (uint8_t workload = 0; workload < 3; workload++)
+	{
+#if defined(EEPROM_MOCK_IN_MEMORY)
+		uint32_t erases[2]{};
+#endif
+
+		for (uint8_t pass = 0; pass < 2; pass++)
+		{
+			EmbeddedEEPROM::EraseEEPROM();
+#if defined(EEPROM_MOCK_IN_MEMORY)
+			EmbeddedEEPROM::ResetMockClock();
+#endif
+			for (uint16_t i = 0; i < 32; i++)
+			{
+				const uint32_t expected = GetBusInvertValue(workload, i);
+				value = expected;
+				if (pass == 0)
+				{
+					unit.WriteData((uint8_t*)&value);
+					value = 0;
+					if (!unit.ReadData((uint8_t*)&value) || value != expected)
+					{
+						Serial.print(F("\tBus Invert invalidated: "));
+						Serial.println(i);
+						OnFail();
+					}
+				}
+				else
+				{
+					plainUnit.WriteData((uint8_t*)&value);
+				}
+			}
+#if defined(EEPROM_MOCK_IN_MEMORY)
+			erases[pass] = EmbeddedEEPROM::MockClock().EraseWrites + EmbeddedEEPROM::MockClock().Erases;
+#endif
+		}
+
+#if defined(EEPROM_MOCK_IN_MEMORY)
+		Serial.print(F("\tWorkload "));
+		Serial.print(workload);
+		Serial.print(F("\terases "));
+		Serial.print(erases[0]);
+		Serial.print(F(" vs "));
+		Serial.println(erases[1]);
+
+		if (erases[0] > erases[1])
+		{
+			Serial.println(F("\tBus Invert erases increased."));
+			OnFail();
+		}
+#endif
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+template<class UnitType>
+void TestCounterUnit()
+{
+	UnitType unit{};
+	const uint16_t count = (UnitType::GetTallyBits() * 3) + 1;
+
+	Serial.print(F("Testing Counter Unit\t"));
+	Serial.print(UnitType::Address());
+	Serial.print(',');
+	Serial.println(UnitType::Size());
+
+	EmbeddedEEPROM::EraseEEPROM();
+	unit.Begin();
+
+	if (unit.Get() != 0)
+	{
+		Serial.println(F("\tCounter not initialized."));
+		OnFail();
+	}
+
+#if defined(EEPROM_MOCK_IN_MEMORY)
+	EmbeddedEEPROM::ResetMockClock();
+#endif
+	for (uint16_t i = 1; i <= count; i++)
+	{
+#if defined(EEPROM_MOCK_IN_MEMORY)
+		const uint32_t erases = EmbeddedEEPROM::MockClock().EraseWrites + EmbeddedEEPROM::MockClock().Erases;
+		const uint32_t writes = EmbeddedEEPROM::MockClock().Writes;
+		const bool commit = (i > 1) && ((i - 1) % UnitType::GetTallyBits()) == 0;
+#endif
+		if (unit.Increment() != i || unit.Get() != i)
+		{
+			Serial.print(F("\tCounter mismatch: "));
+			Serial.println(i);
+			OnFail();
+		}
+#if defined(EEPROM_MOCK_IN_MEMORY)
+		if (!commit
+			&& (EmbeddedEEPROM::MockClock().EraseWrites + EmbeddedEEPROM::MockClock().Erases != erases
+				|| EmbeddedEEPROM::MockClock().Writes != writes + 1))
+		{
+			Serial.print(F("\tCounter increment not write-only: "));
+			Serial.println(i);
+			OnFail();
+		}
+#endif
+	}
+
+#if defined(EEPROM_MOCK_IN_MEMORY)
+	Serial.print(F("\tIncrements "));
+	Serial.print(count);
+	Serial.print(F("\terases "));
+	Serial.println(EmbeddedEEPROM::MockClock().EraseWrites + EmbeddedEEPROM::MockClock().Erases);
+#endif
+
+	UnitType reboot{};
+	reboot.Begin();
+	if (reboot.Get() != count)
+	{
+		Serial.println(F("\tCounter not persisted."));
+		OnFail();
+	}
+
+	reboot.Set(100000);
+	reboot.Increment();
+	if (reboot.Get() != 100001)
+	{
+		Serial.println(F("\tCounter not set."));
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+template<class UnitType, class CommittedUnitType>
+void TestLockedUnit()
+{
+	UnitType unit{};
+	CommittedUnitType committedUnit{};
+	uint16_t value = 0;
+
+	Serial.print(F("Testing Locked Unit\t"));
+	Serial.print(UnitType::Address());
+	Serial.print(',');
+	Serial.println(UnitType::Size());
+
+	EmbeddedEEPROM::EraseEEPROM();
+	unit.Begin();
+
+	for (uint16_t i = 0; i < 10; i++)
+	{
+		value = i;
+		unit.WriteData((uint8_t*)&value);
+
+		value = 0;
+		if (!unit.ReadData((uint8_t*)&value) || value != i)
+		{
+			Serial.print(F("\tLocked read invalidated: "));
+			Serial.println(i);
+			OnFail();
+		}
+
+		value = 0;
+		if (!committedUnit.ReadData((uint8_t*)&value) || value != i)
+		{
+			Serial.print(F("\tCommitted read invalidated: "));
+			Serial.println(i);
+			OnFail();
+		}
+	}
+
+	// Verify and Invalidate go through the lock too, committed reads never take it.
+	TestCountingLockPolicy& lock = UnitLock<TestUnitLockedInner, TestCountingLockPolicy>::Get();
+	const uint8_t locks = lock.Locks;
+	if (!unit.Verify())
+	{
+		Serial.println(F("\tLocked verify invalidated."));
+		OnFail();
+	}
+	unit.Invalidate();
+	if (committedUnit.ReadData((uint8_t*)&value)
+		|| lock.Locks != (locks + 2)
+		|| lock.Unlocks != lock.Locks)
+	{
+		Serial.println(F("\tLocked invalidate invalidated."));
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+template<class UnitType>
+void TestDefaultedUnit(const char* name)
+{
+	UnitType unit{};
+	uint32_t value = 0;
+
+	Serial.print(F("Testing Defaulted Unit "));
+	Serial.print(name);
+	Serial.print('\t');
+	Serial.print(UnitType::Address());
+	Serial.print(',');
+	Serial.println(UnitType::Size());
+
+	EmbeddedEEPROM::EraseEEPROM();
+	unit.Begin();
+
+#if defined(EEPROM_MOCK_IN_MEMORY)
+	EmbeddedEEPROM::ResetMockClock();
+#endif
+	if (unit.ReadData((uint8_t*)&value) || value != TestDefaultValue)
+	{
+		Serial.println(F("\tBlank read default failed."));
+		OnFail();
+	}
+#if defined(EEPROM_MOCK_IN_MEMORY)
+	if (EmbeddedEEPROM::MockClock().EraseWrites + EmbeddedEEPROM::MockClock().Erases + EmbeddedEEPROM::MockClock().Writes > 0)
+	{
+		Serial.println(F("\tBlank read default wrote EEPROM."));
+		OnFail();
+	}
+#endif
+
+	value = 42;
+	unit.WriteData((uint8_t*)&value);
+	value = 0;
+	if (!unit.ReadData((uint8_t*)&value) || value != 42)
+	{
+		Serial.println(F("\tWritten read failed."));
+		OnFail();
+	}
+
+#if defined(EEPROM_MOCK_IN_MEMORY)
+	EmbeddedEEPROM::ResetMockClock();
+#endif
+	unit.Invalidate();
+#if defined(EEPROM_MOCK_IN_MEMORY)
+	if (EmbeddedEEPROM::MockClock().EraseWrites + EmbeddedEEPROM::MockClock().Erases + EmbeddedEEPROM::MockClock().Writes > 1)
+	{
+		Serial.println(F("\tInvalidate wrote more than the CRC."));
+		OnFail();
+	}
+#endif
+	if (unit.ReadData((uint8_t*)&value) || value != TestDefaultValue)
+	{
+		Serial.println(F("\tInvalidated read default failed."));
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+template<class UnitType>
+void TestPackedUnit()
+{
+	UnitType unit{};
+	const TestPackedStruct values[] = {
+		{ false, TestPackedMode::Off, 0, -40, 0 },
+		{ true, TestPackedMode::Service, 1023, 85, 0xFFFFF },
+		{ true, TestPackedMode::Eco, 517, -1, 123456 } };
+	TestPackedStruct value{};
+
+	Serial.print(F("Testing Packed Unit\t"));
+	Serial.print(UnitType::Address());
+	Serial.print(',');
+	Serial.println(UnitType::Size());
+	Serial.print(F("\tPacked "));
+	Serial.print(TestPackedSchema::Size);
+	Serial.print(F(" bytes, struct "));
+	Serial.println(sizeof(TestPackedStruct));
+
+	EmbeddedEEPROM::EraseEEPROM();
+	unit.Begin();
+
+	for (uint8_t i = 0; i < sizeof(values) / sizeof(TestPackedStruct); i++)
+	{
+		unit.WriteData(values[i]);
+
+		value = TestPackedStruct{};
+		if (!unit.ReadData(value)
+			|| value.Enabled != values[i].Enabled
+			|| value.Mode != values[i].Mode
+			|| value.Adc != values[i].Adc
+			|| value.Temperature != values[i].Temperature
+			|| value.Runtime != values[i].Runtime)
+		{
+			Serial.print(F("\tPacked round trip failed: "));
+			Serial.println(i);
+			OnFail();
+		}
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+void TestWearPool()
+{
+	TestPool pool{};
+	WearPoolUnit<0> coldUnit{};
+	WearPoolUnit<2> hotUnit{};
+	uint32_t value = 0;
+
+	Serial.print(F("Testing Wear Pool\t"));
+	Serial.print(TestPool::Address());
+	Serial.print(',');
+	Serial.println(TestPool::Size());
+
+	EmbeddedEEPROM::EraseEEPROM();
+	pool.Begin();
+
+	if (coldUnit.ReadData(pool, (uint8_t*)&value)
+		|| pool.ReadData(1, (uint8_t*)&value))
+	{
+		Serial.println(F("\tBlank pool read failed."));
+		OnFail();
+	}
+
+	value = 1234;
+	coldUnit.WriteData(pool, (uint8_t*)&value);
+
+#if defined(EEPROM_MOCK_IN_MEMORY)
+	// Past the sequence range, the cold owner's data is copied forward.
+	const uint16_t hotWrites = 40000;
+#else
+	const uint16_t hotWrites = 100;
+#endif
+	for (uint16_t i = 1; i <= hotWrites; i++)
+	{
+		value = i;
+		hotUnit.WriteData(pool, (uint8_t*)&value);
+	}
+
+	if (pool.GetOwnedSlots(2) != (TestPool::GetSlotCount() - 1))
+	{
+		Serial.println(F("\tHot owner slots failed."));
+		OnFail();
+	}
+
+	value = 5678;
+	coldUnit.WriteData(pool, (uint8_t*)&value);
+
+	TestPool reboot{};
+	reboot.Begin();
+
+	if (!hotUnit.ReadData(reboot, (uint8_t*)&value) || value != hotWrites)
+	{
+		Serial.println(F("\tHot owner read failed."));
+		OnFail();
+	}
+
+	if (!coldUnit.ReadData(reboot, (uint8_t*)&value) || value != 5678)
+	{
+		Serial.println(F("\tCold owner read failed."));
+		OnFail();
+	}
+
+	for (uint16_t i = 1; i <= TestPool::GetSlotCount(); i++)
+	{
+		value = hotWrites + i;
+		hotUnit.WriteData(reboot, (uint8_t*)&value);
+	}
+
+	pool.Begin();
+	if (!hotUnit.ReadData(pool, (uint8_t*)&value) || value != (uint32_t)hotWrites + TestPool::GetSlotCount()
+		|| !coldUnit.ReadData(pool, (uint8_t*)&value) || value != 5678)
+	{
+		Serial.println(F("\tRebooted pool write failed."));
+		OnFail();
+	}
+
+	Serial.print(F("\tHot owner slots "));
+	Serial.print(pool.GetOwnedSlots(2));
+	Serial.print('/');
+	Serial.println(TestPool::GetSlotCount());
+
+	Serial.println(F("\tValidated."));
+}
+
+uint32_t ScrubbedErrorKey = 0;
+
+void OnScrubError(const uint32_t key, const StorageAddress address)
+{
+	ScrubbedErrorKey = key;
+}
+
+/// <summary>
+/// Steps the scrubber until a full pass completes.
+/// </summary>
+/// <returns>Number of steps, 0 if a step exceeded the simulated budget.</returns>
+const uint16_t RunScrubPass(ReverseStructsScrubber& scrubber, const uint32_t budgetMicros)
+{
+	uint16_t steps = 0;
+	bool completed = false;
+
+	while (!completed)
+	{
+#if defined(EEPROM_MOCK_IN_MEMORY)
+		const uint32_t start = EEPROM_SCRUB_CLOCK();
+#endif
+		completed = scrubber.Step(budgetMicros);
+		steps++;
+
+#if defined(EEPROM_MOCK_IN_MEMORY)
+		// A unit start may read a counter twice over the budget.
+		if ((uint32_t)(EEPROM_SCRUB_CLOCK() - start) > budgetMicros + (17 * (uint32_t)EEPROM_MOCK_PROFILE::ReadMicros))
+		{
+			return 0;
+		}
+#endif
+	}
+
+	return steps;
+}
+
+void TestStorageScrubber()
+{
+	Serial.println(F("Testing Storage Scrubber"));
+
+	ReverseStructsScrubber scrubber(OnScrubError);
+	uint8_t data[sizeof(Storage3Definition::Struct)]{};
+
+	EmbeddedEEPROM::EraseEEPROM();
+	ReverseStructsDispatcher::Begin();
+	ReverseStructsDispatcher::WriteByKey(Storage1Definition::Key, data);
+	ReverseStructsDispatcher::WriteByKey(Storage2Definition::Key, data);
+	ReverseStructsDispatcher::WriteByKey(Storage3Definition::Key, data);
+
+#if defined(EEPROM_MOCK_IN_MEMORY)
+	// Small budget, units are verified over several steps.
+	const uint32_t budget = 2 * EEPROM_MOCK_PROFILE::ReadMicros;
+#else
+	const uint32_t budget = 100;
+#endif
+	const uint16_t steps = RunScrubPass(scrubber, budget);
+
+	if (steps == 0
+		|| scrubber.GetErrorCount() != 0
+		|| scrubber.GetPassCount() != 1)
+	{
+		Serial.println(F("\tClean pass invalidated."));
+		OnFail();
+	}
+
+	Serial.print(F("\tClean pass in "));
+	Serial.print(steps);
+	Serial.println(F(" steps"));
+
+	// Bit rot in a rarely read unit.
+	const StorageAddress address = ReverseStructsAttributor::GetAddressByKey(Storage1Definition::Key);
+	EmbeddedEEPROM::WriteBlock(address, EmbeddedEEPROM::ReadBlock(address) ^ 0x10);
+
+	if (RunScrubPass(scrubber, budget) == 0
+		|| scrubber.GetErrorCount() != 1
+		|| ScrubbedErrorKey != Storage1Definition::Key)
+	{
+		Serial.println(F("\tCorruption not detected."));
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+template<class UnitType>
+void TestChunkedUnit()
+{
+	UnitType unit{};
+	uint8_t source[ChunkedTestSize];
+	uint8_t target[ChunkedTestSize];
+	uint8_t errorMask[UnitType::GetErrorMaskSize()];
+	unit.Begin();
+
+	Serial.print(F("Testing Chunked Unit\t"));
+	Serial.print(UnitType::Address());
+	Serial.print(',');
+	Serial.println(UnitType::Size());
+
+	EmbeddedEEPROM::EraseEEPROM();
+	for (uint8_t i = 0; i < ChunkedTestSize; i++)
+	{
+		source[i] = i * 3;
+	}
+	unit.WriteData(source);
+
+	if (!unit.ReadData(target)
+		|| memcmp(source, target, ChunkedTestSize) != 0)
+	{
+		Serial.println(F("\tChunked Unit invalidated."));
+		OnFail();
+	}
+
+	// Across a chunk boundary, and into the shorter last chunk.
+	const uint8_t field[] = { 0xA1, 0xA2, 0xA3, 0xA4 };
+	if (!unit.WriteRange(14, sizeof(field), field)
+		|| !unit.WriteRange(ChunkedTestSize - 3, 3, field))
+	{
+		Serial.println(F("\tWriteRange failed."));
+		OnFail();
+	}
+	memcpy(&source[14], field, sizeof(field));
+	memcpy(&source[ChunkedTestSize - 3], field, 3);
+
+	if (!unit.ReadData(target, errorMask)
+		|| memcmp(source, target, ChunkedTestSize) != 0)
+	{
+		Serial.println(F("\tWriteRange invalidated."));
+		OnFail();
+	}
+
+	// Corrupted chunk is reported, and only re-signed by a full chunk write.
+	const uint8_t chunk = 3;
+	const uint8_t chunkSize = ChunkedTestChunkSize;
+	EmbeddedEEPROM::WriteBlock(UnitType::Address() + (chunk * (chunkSize + 1)) + 1, 0x55);
+
+	if (unit.ReadData(target, errorMask)
+		|| errorMask[0] != (1 << chunk))
+	{
+		Serial.println(F("\tChunk error mask invalidated."));
+		OnFail();
+	}
+
+	if (unit.WriteRange((chunk * chunkSize) + 1, 1, field)
+		|| !unit.WriteRange(chunk * chunkSize, chunkSize, &source[chunk * chunkSize])
+		|| !unit.ReadData(target)
+		|| memcmp(source, target, ChunkedTestSize) != 0)
+	{
+		Serial.println(F("\tChunk repair invalidated."));
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+template<class UnitType>
+void TestTornRollover()
+{
+	UnitType unit{};
+	const uint8_t option = unit.DebugOption();
+	const uint8_t counterSize = unit.GetCounterSize();
+	uint16_t value = 0;
+
+	Serial.print(F("Testing Torn Rollover x"));
+	Serial.println(option);
+
+	EmbeddedEEPROM::EraseEEPROM();
+	unit.Begin();
+
+	// Fill every slot but the first, the next write rolls the counter over to 0.
+	for (uint16_t i = 1; i < option; i++)
+	{
+		unit.WriteData((uint8_t*)&i);
+	}
+
+	// New data lands in slot 0, reset during the counter erase: only the most significant byte is erased.
+	value = option;
+	StorageEngine::WriteSlot(UnitType::Address() + counterSize, (uint8_t*)&value, sizeof(value), TornRolloverKey, 0);
+	EmbeddedEEPROM::ClearByteToOnes(UnitType::Address() + counterSize - 1);
+
+	unit.Begin();
+	value = 0;
+	if (!unit.ReadData((uint8_t*)&value)
+		|| (value != (option - 1) && value != option))
+	{
+		Serial.print(F("\tTorn rollover read an older slot: "));
+		Serial.println(value);
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+template<class UnitType>
+void TestVersionHistory()
+{
+	UnitType unit{};
+	const uint8_t option = unit.DebugOption();
+	uint16_t value = 0;
+	uint8_t age = 0;
+	uint8_t count = 0;
+	unit.Begin();
+
+	Serial.print(F("Testing Version History x"));
+	Serial.println(option);
+
+	EmbeddedEEPROM::EraseEEPROM();
+	unit.DebugInitialize();
+
+	// Partial history, older slots were never written.
+	for (uint16_t i = 1; i <= 2; i++)
+	{
+		unit.WriteData((uint8_t*)&i);
+	}
+
+	for (age = 0; unit.ReadNextVersion(age, (uint8_t*)&value); age++)
+	{
+		if (value != (2 - age))
+		{
+			Serial.println(F("\tPartial history invalidated."));
+			OnFail();
+		}
+		count++;
+	}
+
+	if (count != 2)
+	{
+		Serial.print(F("\tPartial history count invalidated: "));
+		Serial.println(count);
+		OnFail();
+	}
+
+	// Full history, across a counter rollover.
+	const uint16_t last = option + 3;
+	for (uint16_t i = 3; i <= last; i++)
+	{
+		unit.WriteData((uint8_t*)&i);
+	}
+
+	for (age = 0; age < option; age++)
+	{
+		if (!unit.ReadVersion(age, (uint8_t*)&value)
+			|| value != (last - age))
+		{
+			Serial.print(F("\tVersion invalidated: "));
+			Serial.println(age);
+			OnFail();
+		}
+	}
+
+	if (unit.ReadVersion(option, (uint8_t*)&value))
+	{
+		Serial.println(F("\tVersion out of range."));
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+template<class UnitType, class WearUnitType>
+void TestErrorCorrection()
+{
+	Serial.print(F("Testing Error Correction\t"));
+	Serial.print(UnitType::Address());
+	Serial.print(',');
+	Serial.println(UnitType::Size());
+
+	EmbeddedEEPROM::EraseEEPROM();
+
+	UnitType unit{};
+	uint8_t data[EccTestSize]{};
+	uint8_t value[EccTestSize]{};
+	uint8_t corrections = 0;
+	unit.Begin();
+
+	for (uint8_t i = 0; i < EccTestSize; i++)
+	{
+		data[i] = random(UINT8_MAX);
+	}
+
+	// Single bit flip in Data or CRC is corrected and repaired.
+	// Parity is only checked on CRC mismatch.
+	for (uint16_t offset = 0; offset < UnitType::Size(); offset++)
+	{
+		unit.WriteData(data);
+		EmbeddedEEPROM::WriteBlock(UnitType::Address() + offset, EmbeddedEEPROM::ReadBlock(UnitType::Address() + offset) ^ (1 << (offset % 8)));
+
+		if (!unit.ReadData(value, corrections)
+			|| corrections != (offset <= EccTestSize)
+			|| memcmp(data, value, EccTestSize) != 0)
+		{
+			Serial.print(F("\tCorrection invalidated at offset "));
+			Serial.println(offset);
+			OnFail();
+		}
+
+		if (!unit.ReadData(value, corrections)
+			|| corrections != 0)
+		{
+			Serial.print(F("\tRepair invalidated at offset "));
+			Serial.println(offset);
+			OnFail();
+		}
+	}
+
+	// Double bit flip in one block is detected.
+	unit.WriteData(data);
+	EmbeddedEEPROM::WriteBlock(UnitType::Address(), EmbeddedEEPROM::ReadBlock(UnitType::Address()) ^ 0b11);
+	if (unit.ReadData(value))
+	{
+		Serial.println(F("\tDouble error invalidated."));
+		OnFail();
+	}
+
+	// Uncorrectable, blank or garbage slots fail the read and are never written.
+	uint8_t slot[UnitType::Size()];
+	for (uint8_t pass = 0; pass < 32; pass++)
+	{
+		for (uint16_t i = 0; i < UnitType::Size(); i++)
+		{
+			slot[i] = (pass == 0) ? UINT8_MAX : random(UINT8_MAX + 1);
+			EmbeddedEEPROM::WriteBlock(UnitType::Address() + i, slot[i]);
+		}
+
+		if (!unit.ReadData(value))
+		{
+			for (uint16_t i = 0; i < UnitType::Size(); i++)
+			{
+				if (EmbeddedEEPROM::ReadBlock(UnitType::Address() + i) != slot[i])
+				{
+					Serial.print(F("\tFailed read wrote EEPROM, pass "));
+					Serial.println(pass);
+					OnFail();
+				}
+			}
+		}
+	}
+
+	WearUnitType wearUnit{};
+	wearUnit.Begin();
+	for (uint8_t pass = 0; pass < 4; pass++)
+	{
+		data[0] = pass;
+		wearUnit.WriteData(data);
+		if (!wearUnit.ReadData(value, corrections)
+			|| corrections != 0
+			|| memcmp(data, value, EccTestSize) != 0)
+		{
+			Serial.println(F("\tWear Level readback invalidated."));
+			OnFail();
+		}
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+#if defined(EEPROM_TRACE)
+void TestEepromTrace()
+{
+	Serial.println(F("Testing EEPROM Trace"));
+
+	TestUnitTiny5 unit{};
+	LoopbackStream stream{};
+	TraceEntry entry{};
+	uint16_t value = 0x1234;
+	unit.Begin();
+
+	EmbeddedEEPROM::EraseEEPROM();
+	unit.DebugInitialize();
+	EmbeddedTrace::Clear();
+	unit.WriteData((uint8_t*)&value);
+
+	// Slot marker and its changed bytes, then the counter increment commits the slot.
+	if (!EmbeddedTrace::Take(entry)
+		|| entry.Operation != TraceOperation::Slot
+		|| entry.Address != (TestUnitTiny5::Address() + TestUnitTiny5::GetCounterSize() + EmbeddedStorage::GetStorageSize(sizeof(value)))
+		|| !EmbeddedTrace::Take(entry)
+		|| entry.Operation != TraceOperation::EraseWrite)
+	{
+		Serial.println(F("\tTrace order invalidated."));
+		OnFail();
+	}
+
+	while (EmbeddedTrace::Take(entry)
+		&& entry.Operation == TraceOperation::EraseWrite);
+
+	if (entry.Operation != TraceOperation::Write
+		|| entry.Address != TestUnitTiny5::Address())
+	{
+		Serial.println(F("\tTrace commit invalidated."));
+		OnFail();
+	}
+
+	// Overflows the ring, the oldest entries are dropped.
+	// Every write traces at least its slot marker and counter, whatever the EEPROM_TRACE_SIZE.
+	for (uint16_t i = 0; i < EEPROM_TRACE_SIZE && EmbeddedTrace::GetDropped() == 0; i++)
+	{
+		value++;
+		unit.WriteData((uint8_t*)&value);
+	}
+
+	if (EmbeddedTrace::GetCount() != EEPROM_TRACE_SIZE
+		|| EmbeddedTrace::GetDropped() == 0)
+	{
+		Serial.println(F("\tTrace ring invalidated."));
+		OnFail();
+	}
+
+	if (EmbeddedTrace::Export(stream) != EEPROM_TRACE_SIZE
+		|| EmbeddedTrace::GetCount() != 0
+		|| stream.read() != '#')
+	{
+		Serial.println(F("\tTrace Export() invalidated."));
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+#endif
+
+void DeferredWrite(const uint8_t id, const uint8_t* payload)
+{
+	switch (id)
+	{
+	case 0:
+		TestDeferredUnit0().WriteData(payload);
+		break;
+	case 1:
+		TestDeferredUnit1().WriteData(payload);
+		break;
+	default:
+		break;
+	}
+}
+
+void TestDeferredWriteQueue()
+{
+	Serial.println(F("Testing Deferred Write Queue"));
+
+	EmbeddedEEPROM::EraseEEPROM();
+
+	TestDeferredQueue queue{};
+	uint16_t value = 0;
+	uint8_t id = 0;
+
+	// Enqueue as if from an ISR: 1, 0, then 1 again is coalesced.
+	value = 100;
+	queue.Enqueue(1, (uint8_t*)&value);
+	value = 200;
+	queue.Enqueue(0, (uint8_t*)&value);
+	value = 101;
+	queue.Enqueue(1, (uint8_t*)&value);
+
+	if (queue.Enqueue(TestDeferredQueue::GetUnitCount(), (uint8_t*)&value)
+		|| queue.GetPendingCount() != 2
+		|| queue.GetCoalescedCount() != 1)
+	{
+		Serial.println(F("\tEnqueue invalidated."));
+		OnFail();
+	}
+
+	if (!queue.Dequeue(id, (uint8_t*)&value)
+		|| id != 1 || value != 101)
+	{
+		Serial.println(F("\tCoalesced order invalidated."));
+		OnFail();
+	}
+
+	// Enqueued again after being dequeued, written again.
+	value = 102;
+	queue.Enqueue(1, (uint8_t*)&value);
+
+	if (queue.Drain(DeferredWrite) != 2
+		|| queue.GetPendingCount() != 0)
+	{
+		Serial.println(F("\tDrain invalidated."));
+		OnFail();
+	}
+
+	if (!TestDeferredUnit0().ReadData((uint8_t*)&value) || value != 200
+		|| !TestDeferredUnit1().ReadData((uint8_t*)&value) || value != 102)
+	{
+		Serial.println(F("\tDrained writes invalidated."));
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+
+#if defined(EEPROM_MOCK_IN_MEMORY)
+void TestMockDevices()
+{
+	Serial.println(F("Testing Mock Devices"));
+
+	TemplateMockEepromDevice<DeviceProfileTest> devices[2];
+	TestUnitStorage unit{};
+	uint8_t value = 0;
+
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		MockEepromDevice::Select(&devices[i]);
+		value = 10 + i;
+		unit.WriteData(&value);
+	}
+
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		MockEepromDevice::Select(&devices[i]);
+		if (!unit.ReadData(&value)
+			|| value != (10 + i)
+			|| devices[i].Clock.EraseWrites == 0
+			|| EmbeddedEEPROM::MockClock().ElapsedMicros != devices[i].Clock.ElapsedMicros)
+		{
+			Serial.print(F("\tDevice invalidated: "));
+			Serial.println(i);
+			MockEepromDevice::Select(nullptr);
+			OnFail();
+		}
+	}
+
+	// Accesses beyond the selected device's capacity are refused, not written.
+	using BeyondUnit = StorageUnit<EmbeddedEEPROM::Size() - 8, sizeof(uint32_t)>;
+	uint32_t beyond = 0x12345678;
+	MockEepromDevice::Select(&devices[0]);
+	BeyondUnit().WriteData((uint8_t*)&beyond);
+	if (EmbeddedEEPROM::MockSize() != DeviceProfileTest::Capacity
+		|| BeyondUnit().ReadData((uint8_t*)&beyond)
+		|| beyond != UINT32_MAX
+		|| devices[0].Clock.Refused != (2 * BeyondUnit::Size()))
+	{
+		Serial.println(F("\tDevice bounds invalidated."));
+		MockEepromDevice::Select(nullptr);
+		OnFail();
+	}
+
+	MockEepromDevice::Select(nullptr);
+	if (EmbeddedEEPROM::MockDevice().Capacity != EmbeddedEEPROM::Size())
+	{
+		Serial.println(F("\tDefault device invalidated."));
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+#endif
+
+#if defined(EEPROM_MOCK_IN_MEMORY)
+template<class UnitType, typename SchedulerType>
+void WriteStripedUnit(SchedulerType& scheduler, const uint8_t pass, const uint8_t seed)
+{
+	uint8_t data[StripeDefinition0::Size];
+
+	for (uint8_t i = 0; i < sizeof(data); i++)
+	{
+		data[i] = (pass * 31) + (seed * 7) + i;
+	}
+
+	UnitType().WriteData(scheduler, data);
+}
+
+template<class UnitType, typename SchedulerType>
+const bool ValidateStripedUnit(SchedulerType& scheduler, const uint8_t pass, const uint8_t seed)
+{
+	uint8_t data[StripeDefinition0::Size];
+
+	if (!UnitType().ReadData(scheduler, data))
+	{
+		return false;
+	}
+
+	for (uint8_t i = 0; i < sizeof(data); i++)
+	{
+		if (data[i] != (uint8_t)((pass * 31) + (seed * 7) + i))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Writes all 4 units a few times, interleaved.
+/// </summary>
+/// <returns>Simulated bus time until every write cycle has started, in microseconds.</returns>
+template<class Unit0, class Unit1, class Unit2, class Unit3, typename SchedulerType>
+const uint32_t RunStripedWrites(SchedulerType& scheduler, MockStripeBus& bus)
+{
+	static constexpr uint8_t Passes = 4;
+
+	const uint32_t start = bus.ElapsedMicros;
+	for (uint8_t pass = 0; pass < Passes; pass++)
+	{
+		WriteStripedUnit<Unit0>(scheduler, pass, 0);
+		WriteStripedUnit<Unit1>(scheduler, pass, 1);
+		WriteStripedUnit<Unit2>(scheduler, pass, 2);
+		WriteStripedUnit<Unit3>(scheduler, pass, 3);
+	}
+	scheduler.Flush();
+	const uint32_t elapsed = bus.ElapsedMicros - start;
+
+	if (!ValidateStripedUnit<Unit0>(scheduler, Passes - 1, 0)
+		|| !ValidateStripedUnit<Unit1>(scheduler, Passes - 1, 1)
+		|| !ValidateStripedUnit<Unit2>(scheduler, Passes - 1, 2)
+		|| !ValidateStripedUnit<Unit3>(scheduler, Passes - 1, 3))
+	{
+		Serial.print(F("\tStriped data invalidated: "));
+		Serial.println(SchedulerType::GetDeviceCount());
+		OnFail();
+	}
+
+	Serial.print(F("\tDevices "));
+	Serial.print(SchedulerType::GetDeviceCount());
+	Serial.print(F("\t"));
+	Serial.print(elapsed);
+	Serial.println(F(" us"));
+
+	return elapsed;
+}
+
+void TestStripedStorage()
+{
+	Serial.println(F("Testing Striped Storage"));
+
+	static constexpr uint8_t PageSize = DeviceProfileStripeTest::EraseGranularity;
+
+	TemplateMockEepromDevice<DeviceProfileStripeTest> memories[5];
+	MockStripeBus bus{};
+	MockStripeDevice byteDevice(memories[4], bus, 1);
+	MockStripeDevice devices[4] = { { memories[0], bus, PageSize }, { memories[1], bus, PageSize }, { memories[2], bus, PageSize }, { memories[3], bus, PageSize } };
+	MockStripeDevice* const bytes[1] = { &byteDevice };
+	MockStripeDevice* const single[1] = { &devices[0] };
+	MockStripeDevice* const dual[2] = { &devices[0], &devices[1] };
+	MockStripeDevice* const quad[4] = { &devices[0], &devices[1], &devices[2], &devices[3] };
+
+	StripedWriteScheduler<MockStripeDevice, 1> byteScheduler(bytes);
+	StripedWriteScheduler<MockStripeDevice, 1> singleScheduler(single);
+	StripedWriteScheduler<MockStripeDevice, 2> dualScheduler(dual);
+	StripedWriteScheduler<MockStripeDevice, 4> quadScheduler(quad);
+	byteScheduler.Begin();
+	singleScheduler.Begin();
+	dualScheduler.Begin();
+	quadScheduler.Begin();
+
+	Serial.println(F("\tByte writes"));
+	const uint32_t byteMicros = RunStripedWrites<TestUnitSingle0, TestUnitSingle1, TestUnitSingle2, TestUnitSingle3>(byteScheduler, bus);
+	Serial.println(F("\tPage writes"));
+	const uint32_t singleMicros = RunStripedWrites<TestUnitSingle0, TestUnitSingle1, TestUnitSingle2, TestUnitSingle3>(singleScheduler, bus);
+	const uint32_t dualMicros = RunStripedWrites<TestUnitStriped0, TestUnitStriped1, TestUnitStriped2, TestUnitStriped3>(dualScheduler, bus);
+	const uint32_t quadMicros = RunStripedWrites<TestUnitQuad0, TestUnitQuad1, TestUnitQuad2, TestUnitQuad3>(quadScheduler, bus);
+
+	// Page writes program a whole slot per cycle.
+	if ((singleMicros * 5) > byteMicros)
+	{
+		Serial.println(F("\tPage write speedup invalidated."));
+		OnFail();
+	}
+
+	// Against a single device with page writes, only bus time is serialized.
+	if ((dualMicros * 14) > (singleMicros * 10)
+		|| (quadMicros * 25) > (singleMicros * 10))
+	{
+		Serial.println(F("\tStriping speedup invalidated."));
+		OnFail();
+	}
+
+	Serial.println(F("\tValidated."));
+}
+#endif
+
+#if defined(EEPROM_MOCK_IN_MEMORY)
+template<class UnitType>
+void TestWriteLatency(String name, const uint8_t counterSize, const uint8_t levels)
+{
+	using Profile = EEPROM_MOCK_PROFILE;
+
+	// Slot bytes are updated, counter bytes are read twice and programmed or erased.
+	const uint32_t worstCase = ((TimingTestSize + 1) * (uint32_t)(Profile::ReadMicros + Profile::EraseWriteMicros))
+		+ (counterSize * (uint32_t)((2 * Profile::ReadMicros) + max(Profile::EraseMicros, Profile::WriteMicros)));
+
+	Serial.print(F("Testing Write Latency "));
+	Serial.print(name);
+	Serial.print(F("\tWorst case "));
+	Serial.print(worstCase);
+	Serial.println(F(" us"));
+
+	EmbeddedEEPROM::EraseEEPROM();
+
+	UnitType unit{};
+	uint8_t data[TimingTestSize]{};
+	uint32_t maxLatency = 0;
+	unit.Begin();
+
+	// One more write than levels, to roll the counter over.
+	for (uint8_t pass = 0; pass <= levels; pass++)
+	{
+		for (uint8_t i = 0; i < TimingTestSize; i++)
+		{
+			data[i] = (pass + i) % INT8_MAX;
+		}
+
+		EmbeddedEEPROM::ResetMockClock();
+		unit.WriteData(data);
+		const uint32_t latency = EmbeddedEEPROM::MockClock().ElapsedMicros;
+
+		if (latency > maxLatency)
+		{
+			maxLatency = latency;
+		}
+	}
+
+	Serial.print(F("\tMeasured "));
+	Serial.print(maxLatency);
+	Serial.println(F(" us"));
+
+	if (maxLatency > worstCase
+		|| maxLatency < ((TimingTestSize + 1) * (uint32_t)Profile::EraseWriteMicros))
+	{
+		Serial.println(F("\tWrite latency invalidated."));
+		OnFail();
+	}
+
+	// Unchanged data is only read back, EEPROM.update() skips every byte.
+	if (levels == 1)
+	{
+		EmbeddedEEPROM::ResetMockClock();
+		unit.WriteData(data);
+		if (EmbeddedEEPROM::MockClock().EraseWrites != 0
+			|| EmbeddedEEPROM::MockClock().ElapsedMicros != ((TimingTestSize + 1) * (uint32_t)Profile::ReadMicros))
+		{
+			Serial.println(F("\tUnchanged write latency invalidated."));
+			OnFail();
+		}
+	}
+
+	Serial.println(F("\tValidated."));
+}
+#endif
@@ -0,0 +1,15 @@
+/*
+	Host shim for the Arduino EEPROM library.
+	EEPROM_MOCK_IN_MEMORY keeps the data in MockEepromDevice, only begin() is called.
+*/
+
+#ifndef _HOST_SHIM_EEPROM_
+#define _HOST_SHIM_EEPROM_
+
+struct EEPROMClass
+{
+	void begin() {}
+};
+
+static EEPROMClass EEPROM;
+#endif
@@ -0,0 +1,18 @@
+/*
+	Host shim for avr/pgmspace.h.
+	PROGMEM tables are plain const data on the host.
+*/
+
+#ifndef _HOST_SHIM_PGMSPACE_
+#define _HOST_SHIM_PGMSPACE_
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+
+#define memcpy_P memcpy
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define pgm_read_dword(address) (*(const uint32_t*)(address))
+#endif
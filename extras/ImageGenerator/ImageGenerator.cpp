@@ -0,0 +1,208 @@
+/*
+	Image Generator.
+	Host tool, builds a factory EEPROM image of a TemplateStorageDispatcher layout, with default values.
+	Defaults are written through the same units as the firmware, on the in-memory EEPROM mock,
+	 so CRCs (Key and slot salt), wear level counters and the stored layout fingerprint match the firmware's.
+	Program the image along with the flash: on first boot the dispatcher's Begin() finds the fingerprint,
+	 every unit reads valid and nothing is written.
+
+	Data types must have the same layout on the host as on the target:
+	 fixed width members, packed, little endian.
+	Unused bytes are left erased (0xFF). The image covers the layout only, from address 0.
+
+	Build (with https://github.com/RobTillaart/CRC on the include path):
+		g++ -std=c++11 -I../HostShim -I../../src -I<CRC>/src ImageGenerator.cpp -o ImageGenerator
+
+	Usage:
+		ImageGenerator <image.eep>	Intel HEX.
+		ImageGenerator <image.bin>	Raw binary.
+
+	Programming, i.e. ATmega328P:
+		avrdude -p m328p -c usbasp -U flash:w:firmware.hex:i -U eeprom:w:image.eep:i
+*/
+
+#define EEPROM_MOCK_IN_MEMORY
+
+// Edit to match the target.
+#define EEPROM_MOCK_PROFILE DeviceProfileATmega328P
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <StorageDispatcher.h>
+
+template<const uint32_t key, typename DataType, typename WearLevelType, const WearLevelType option>
+struct FactoryDefinition
+{
+	static constexpr uint16_t Size = sizeof(DataType);
+	static constexpr uint32_t Key = key;
+	static constexpr WearLevelType WearLevelOption = option;
+};
+
+// Edit to match the firmware: same definitions, in the same order.
+struct __attribute__((packed)) FactorySettings
+{
+	uint8_t Brightness;
+	uint16_t TimeoutSeconds;
+	int16_t Calibration;
+};
+
+struct __attribute__((packed)) FactoryCounters
+{
+	uint32_t PowerCycles;
+	uint32_t RunMinutes;
+};
+
+using SettingsDefinition = FactoryDefinition<100001, FactorySettings, NoWearLevel, NoWearLevel::x1>;
+using CountersDefinition = FactoryDefinition<100002, FactoryCounters, WearLevelTiny, WearLevelTiny::x5>;
+using SerialDefinition = FactoryDefinition<100003, uint32_t, NoWearLevel, NoWearLevel::x1>;
+
+using FactoryLayout = TemplateStorageDispatcher<SettingsDefinition, CountersDefinition, SerialDefinition>;
+
+static_assert(FactoryLayout::GetUsed() <= EEPROM_MOCK_PROFILE::Capacity, "Layout exceeds the EEPROM_MOCK_PROFILE capacity.");
+
+/// <summary>
+/// Writes every unit's default value.
+/// Edit to match the firmware's defaults.
+/// </summary>
+static void WriteDefaults()
+{
+	const FactorySettings settings{ 128, 300, 0 };
+	const FactoryCounters counters{ 0, 0 };
+	const uint32_t serial = 0;
+
+	FactoryLayout::WriteByKey(SettingsDefinition::Key, (const uint8_t*)&settings);
+	FactoryLayout::WriteByKey(CountersDefinition::Key, (const uint8_t*)&counters);
+	FactoryLayout::WriteByKey(SerialDefinition::Key, (const uint8_t*)&serial);
+}
+
+/// <summary>
+/// Replays the firmware's first boot on the generated image.
+/// </summary>
+/// <returns>True if the fingerprint matched, every unit read valid and nothing was written.</returns>
+static bool CheckFirstBoot()
+{
+	const uint32_t keys[] = { SettingsDefinition::Key, CountersDefinition::Key, SerialDefinition::Key };
+	uint8_t buffer[sizeof(FactorySettings) + sizeof(FactoryCounters)];
+
+	EmbeddedEEPROM::ResetMockClock();
+
+	bool valid = FactoryLayout::Begin();
+	for (uint8_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++)
+	{
+		StorageEntry entry;
+		valid &= FactoryLayout::Find(keys[i], entry)
+			&& entry.Size <= sizeof(buffer)
+			&& FactoryLayout::ReadByKey(keys[i], buffer);
+	}
+
+	const EmbeddedEEPROMClock clock = EmbeddedEEPROM::MockClock();
+
+	printf("First boot: %lu reads, %lu writes.\n", (unsigned long)clock.Reads,
+		(unsigned long)(clock.EraseWrites + clock.Erases + clock.Writes));
+
+	return valid
+		&& clock.EraseWrites == 0
+		&& clock.Erases == 0
+		&& clock.Writes == 0;
+}
+
+static void WriteHexRecord(FILE* file, const uint8_t type, const uint16_t offset, const uint8_t* data, const uint8_t length)
+{
+	uint8_t checksum = length + (offset >> 8) + (offset & UINT8_MAX) + type;
+
+	fprintf(file, ":%02X%04X%02X", length, offset, type);
+	for (uint8_t i = 0; i < length; i++)
+	{
+		fprintf(file, "%02X", data[i]);
+		checksum += data[i];
+	}
+	fprintf(file, "%02X\n", (uint8_t)(0 - checksum));
+}
+
+/// <summary>
+/// Intel HEX, as read by avrdude's :i format.
+/// Extended linear address records are only emitted above 64 KB.
+/// </summary>
+static void WriteHex(FILE* file, const uint8_t* image, const uint32_t size)
+{
+	static constexpr uint8_t RecordSize = 16;
+
+	for (uint32_t address = 0; address < size; address += RecordSize)
+	{
+		if (address > 0 && (address & UINT16_MAX) == 0)
+		{
+			const uint8_t upper[2] = { (uint8_t)(address >> 24), (uint8_t)(address >> 16) };
+			WriteHexRecord(file, 0x04, 0, upper, sizeof(upper));
+		}
+
+		const uint8_t length = ((size - address) < RecordSize) ? (size - address) : RecordSize;
+		WriteHexRecord(file, 0x00, address & UINT16_MAX, &image[address], length);
+	}
+
+	WriteHexRecord(file, 0x01, 0, nullptr, 0);
+}
+
+static bool EndsWith(const char* text, const char* suffix)
+{
+	const size_t textLength = strlen(text);
+	const size_t suffixLength = strlen(suffix);
+
+	return textLength >= suffixLength
+		&& strcmp(text + textLength - suffixLength, suffix) == 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 2)
+	{
+		printf("Usage:\n\tImageGenerator <image.eep|image.bin>\n");
+
+		return 1;
+	}
+
+	EmbeddedEEPROM::EraseEEPROM();
+	FactoryLayout::Begin();
+	WriteDefaults();
+
+	const uint32_t size = FactoryLayout::GetUsed();
+	uint8_t* image = (uint8_t*)malloc(size);
+	for (uint32_t i = 0; i < size; i++)
+	{
+		image[i] = EmbeddedEEPROM::MockDevice().Memory[i];
+	}
+
+	if (!CheckFirstBoot())
+	{
+		printf("First boot check failed.\n");
+		free(image);
+
+		return 1;
+	}
+
+	FILE* file = fopen(argv[1], EndsWith(argv[1], ".bin") ? "wb" : "w");
+	if (file == nullptr)
+	{
+		printf("Unable to open %s\n", argv[1]);
+		free(image);
+
+		return 1;
+	}
+
+	if (EndsWith(argv[1], ".bin"))
+	{
+		fwrite(image, 1, size, file);
+	}
+	else
+	{
+		WriteHex(file, image, size);
+	}
+	fclose(file);
+	free(image);
+
+	printf("%lu bytes written to %s\n", (unsigned long)size, argv[1]);
+
+	return 0;
+}
@@ -0,0 +1,439 @@
+/*
+	Thread Stress Benchmark.
+	Host tool, runs LockedUnit reads and writes from std::thread workers on the in-memory EEPROM mock.
+
+	Scaling: each thread reads and writes its own unit, on its own selected mock device.
+	 Units have independent locks, so throughput grows with the thread count, up to the core count.
+	Readers: one writer and several readers on a single wear level unit,
+	 with locked readers and with committed (lock-free) readers.
+	 Mixed: one writer through each ReadMode wrapper, both must share the unit's lock.
+	Devices: two threads write and read the same unit, each on its own selected mock device.
+	 Each device must hold its own thread's data, the default device must be untouched.
+	Deferred: a producer thread stands in for the ISR, enqueueing into a DeferredWriteQueue,
+	 while the main thread dequeues. Payloads must never be torn, per unit values never go back,
+	 and the last value of every unit is delivered.
+	 Unlike an ISR, the thread can be preempted by the consumer mid-Enqueue:
+	 the latest payload may then be delivered twice, which the test allows.
+	Every read is validated, a torn value is a failure.
+	Readers share the default mock device, its memory and clock counters are plain shared bytes, as on the device.
+	 ThreadSanitizer reports the committed readers and the shared clock counters as races.
+
+	Build (with https://github.com/RobTillaart/CRC on the include path):
+		g++ -std=c++11 -O2 -pthread -I../HostShim -I../../src -I<CRC>/src ThreadStress.cpp -o ThreadStress
+
+	Usage:
+		ThreadStress [milliseconds per run]
+*/
+
+#define EEPROM_MOCK_IN_MEMORY
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <StorageUnit.h>
+#include <WearLevelUnit.h>
+#include <LockedUnit.h>
+#include <DeferredWriteQueue.h>
+
+static constexpr uint8_t MaxThreads = 8;
+static constexpr StorageAddress StressUnitSpan = 32;
+
+template<const uint8_t index, const LockedRead ReadMode = LockedRead::Locked>
+using StressUnit = LockedUnit<TinyWearLevelUnit<index * StressUnitSpan, sizeof(uint32_t), WearLevelTiny::x4>, MutexLockPolicy, ReadMode>;
+
+struct StressResult
+{
+	std::atomic<uint64_t> Operations{};
+	std::atomic<uint64_t> Failures{};
+};
+
+/// <summary>
+/// Value with every byte equal, so a torn read is detectable.
+/// </summary>
+static uint32_t GetStressValue(const uint32_t sequence)
+{
+	return (sequence & UINT8_MAX) * 0x01010101UL;
+}
+
+static bool IsStressValue(const uint32_t value)
+{
+	return value == GetStressValue(value);
+}
+
+template<typename UnitType>
+static void RunWriterReader(const std::atomic<bool>& running, StressResult& result)
+{
+	UnitType unit{};
+	uint32_t sequence = 0;
+	uint32_t value = 0;
+	uint64_t operations = 0;
+
+	while (running.load(std::memory_order_relaxed))
+	{
+		value = GetStressValue(++sequence);
+		unit.WriteData((const uint8_t*)&value);
+		if (!unit.ReadData((uint8_t*)&value) || value != GetStressValue(sequence))
+		{
+			result.Failures++;
+		}
+		operations += 2;
+	}
+
+	result.Operations += operations;
+}
+
+template<typename UnitType>
+static void RunWriter(const std::atomic<bool>& running, StressResult& result)
+{
+	UnitType unit{};
+	uint32_t sequence = 0;
+	uint32_t value = 0;
+	uint64_t operations = 0;
+
+	while (running.load(std::memory_order_relaxed))
+	{
+		value = GetStressValue(++sequence);
+		unit.WriteData((const uint8_t*)&value);
+		operations++;
+	}
+
+	result.Operations += operations;
+}
+
+template<typename UnitType>
+static void RunReader(const std::atomic<bool>& running, StressResult& result)
+{
+	UnitType unit{};
+	uint32_t value = 0;
+	uint64_t operations = 0;
+	uint64_t failures = 0;
+
+	while (running.load(std::memory_order_relaxed))
+	{
+		if (!unit.ReadData((uint8_t*)&value) || !IsStressValue(value))
+		{
+			failures++;
+		}
+		operations++;
+	}
+
+	result.Operations += operations;
+	result.Failures += failures;
+}
+
+static TemplateMockEepromDevice<EEPROM_MOCK_PROFILE> ScalingDevices[MaxThreads];
+
+/// <summary>
+/// Selects the thread's own device, so threads share no memory or clock counters.
+/// </summary>
+template<const uint8_t index>
+static void RunScaling(const std::atomic<bool>& running, StressResult& result)
+{
+	MockEepromDevice::Select(&ScalingDevices[index]);
+	StressUnit<index>().Begin();
+
+	RunWriterReader<StressUnit<index>>(running, result);
+}
+
+using SelectedUnit = StorageUnit<0, sizeof(uint32_t)>;
+
+static void RunSelected(MockEepromDevice* device, const uint32_t seed, const uint32_t count, std::atomic<uint64_t>& failures)
+{
+	MockEepromDevice::Select(device);
+
+	SelectedUnit unit{};
+	uint32_t value = 0;
+	unit.Begin();
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		value = seed + i;
+		unit.WriteData((const uint8_t*)&value);
+		if (!unit.ReadData((uint8_t*)&value) || value != (seed + i))
+		{
+			failures++;
+		}
+	}
+
+	if (&EmbeddedEEPROM::MockDevice() != device)
+	{
+		failures++;
+	}
+}
+
+/// <summary>
+/// Two threads on the same unit, each on its own selected device.
+/// </summary>
+/// <returns>Number of failures.</returns>
+static uint64_t RunDevices(const uint32_t count)
+{
+	static constexpr uint32_t Seeds[2] = { 0x10000000, 0x20000000 };
+
+	TemplateMockEepromDevice<EEPROM_MOCK_PROFILE> devices[2];
+	std::atomic<uint64_t> failures{};
+	const uint32_t defaultReads = EmbeddedEEPROM::MockClock().Reads;
+
+	std::thread first(RunSelected, &devices[0], Seeds[0], count, std::ref(failures));
+	std::thread second(RunSelected, &devices[1], Seeds[1], count, std::ref(failures));
+	first.join();
+	second.join();
+
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		uint32_t value = 0;
+
+		MockEepromDevice::Select(&devices[i]);
+		if (!SelectedUnit().ReadData((uint8_t*)&value)
+			|| value != (Seeds[i] + count - 1))
+		{
+			failures++;
+		}
+	}
+	MockEepromDevice::Select(nullptr);
+
+	if (EmbeddedEEPROM::MockClock().Reads != defaultReads)
+	{
+		failures++;
+	}
+
+	printf("\tSelected\twrites %lu, %lu\tfailures %llu\n",
+		(unsigned long)devices[0].Clock.EraseWrites, (unsigned long)devices[1].Clock.EraseWrites,
+		(unsigned long long)failures.load());
+
+	return failures;
+}
+
+static constexpr uint8_t DeferredUnitCount = 4;
+static constexpr uint8_t DeferredPayloadCount = 32;
+
+using StressQueue = DeferredWriteQueue<DeferredUnitCount, DeferredPayloadCount * sizeof(uint32_t)>;
+
+/// <summary>
+/// Copies of the same value, a large payload widens the window for a torn copy.
+/// </summary>
+static bool IsDeferredPayload(const uint32_t* payload)
+{
+	for (uint8_t i = 1; i < DeferredPayloadCount; i++)
+	{
+		if (payload[i] != payload[0])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// <summary>
+/// ISR stand-in, enqueues increasing values round robin.
+/// </summary>
+static void RunProducer(StressQueue& queue, const std::atomic<bool>& running, uint32_t* lastValues)
+{
+	uint32_t value = 0;
+
+	while (running.load(std::memory_order_relaxed))
+	{
+		const uint8_t id = value % DeferredUnitCount;
+		uint32_t payload[DeferredPayloadCount];
+
+		value++;
+		for (uint8_t i = 0; i < DeferredPayloadCount; i++)
+		{
+			payload[i] = value;
+		}
+
+		queue.Enqueue(id, (const uint8_t*)payload);
+		lastValues[id] = value;
+	}
+}
+
+/// <summary>
+/// Main loop stand-in, dequeues until the producer has stopped and the queue is empty.
+/// </summary>
+/// <returns>Number of failed dequeues.</returns>
+static uint64_t RunDeferred(const uint32_t milliseconds)
+{
+	StressQueue queue{};
+	std::atomic<bool> running{ true };
+	uint32_t lastValues[DeferredUnitCount]{};
+	uint32_t dequeuedValues[DeferredUnitCount]{};
+	uint32_t payload[DeferredPayloadCount];
+	uint64_t dequeued = 0;
+	uint64_t failures = 0;
+	uint8_t id = 0;
+
+	std::thread producer(RunProducer, std::ref(queue), std::cref(running), lastValues);
+	const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+
+	while (std::chrono::steady_clock::now() < end)
+	{
+		while (queue.Dequeue(id, (uint8_t*)payload))
+		{
+			if (id >= DeferredUnitCount
+				|| !IsDeferredPayload(payload)
+				|| payload[0] < dequeuedValues[id])
+			{
+				failures++;
+			}
+			else
+			{
+				dequeuedValues[id] = payload[0];
+			}
+			dequeued++;
+		}
+	}
+
+	running = false;
+	producer.join();
+
+	while (queue.Dequeue(id, (uint8_t*)payload))
+	{
+		if (id < DeferredUnitCount && IsDeferredPayload(payload))
+		{
+			dequeuedValues[id] = payload[0];
+		}
+		dequeued++;
+	}
+
+	for (uint8_t i = 0; i < DeferredUnitCount; i++)
+	{
+		if (dequeuedValues[i] != lastValues[i])
+		{
+			failures++;
+		}
+	}
+
+	printf("\tDeferred\tdequeues %.0f/s\tfailures %llu\n",
+		(dequeued * 1000.0) / milliseconds, (unsigned long long)failures);
+
+	return failures;
+}
+
+using StressFunction = void (*)(const std::atomic<bool>&, StressResult&);
+
+static const StressFunction ScalingFunctions[MaxThreads] = {
+	RunScaling<0>, RunScaling<1>,
+	RunScaling<2>, RunScaling<3>,
+	RunScaling<4>, RunScaling<5>,
+	RunScaling<6>, RunScaling<7> };
+
+/// <summary>
+/// Runs one thread per function, for milliseconds.
+/// </summary>
+/// <returns>Operations per second, of the threads from first.</returns>
+static double Run(const std::vector<StressFunction>& functions, const uint32_t milliseconds, StressResult* results, const size_t first = 0)
+{
+	std::atomic<bool> running{ true };
+	std::vector<std::thread> threads;
+
+	for (size_t i = 0; i < functions.size(); i++)
+	{
+		threads.emplace_back(functions[i], std::cref(running), std::ref(results[i]));
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+	running = false;
+
+	uint64_t operations = 0;
+	for (size_t i = 0; i < threads.size(); i++)
+	{
+		threads[i].join();
+		if (i >= first)
+		{
+			operations += results[i].Operations;
+		}
+	}
+
+	return (operations * 1000.0) / milliseconds;
+}
+
+static uint64_t GetFailures(const StressResult* results, const size_t count)
+{
+	uint64_t failures = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		failures += results[i].Failures;
+	}
+
+	return failures;
+}
+
+int main(int argc, char** argv)
+{
+	const uint32_t milliseconds = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 500;
+	uint64_t failures = 0;
+
+	EmbeddedEEPROM::EraseEEPROM();
+	StressUnit<0>().Begin();
+
+	printf("Scaling, one unit per thread\n");
+	double single = 0;
+	for (uint8_t count = 1; count <= MaxThreads; count *= 2)
+	{
+		StressResult results[MaxThreads];
+		const double rate = Run(std::vector<StressFunction>(ScalingFunctions, ScalingFunctions + count), milliseconds, results);
+
+		if (count == 1)
+		{
+			single = rate;
+		}
+		failures += GetFailures(results, count);
+
+		printf("\t%u threads\t%.0f ops/s\tx%.2f\n", count, rate, rate / single);
+	}
+
+	printf("Readers, writers and readers on one unit\n");
+	const char* modeNames[] = { "Locked", "Committed", "Mixed" };
+	for (uint8_t mode = 0; mode < 3; mode++)
+	{
+		StressResult results[MaxThreads];
+		std::vector<StressFunction> functions;
+
+		if (mode == 0)
+		{
+			functions.push_back(RunWriter<StressUnit<0>>);
+			functions.resize(MaxThreads, RunReader<StressUnit<0>>);
+		}
+		else if (mode == 1)
+		{
+			functions.push_back(RunWriter<StressUnit<0, LockedRead::Committed>>);
+			functions.resize(MaxThreads, RunReader<StressUnit<0, LockedRead::Committed>>);
+		}
+		else
+		{
+			functions.push_back(RunWriter<StressUnit<0>>);
+			functions.push_back(RunWriter<StressUnit<0, LockedRead::Committed>>);
+			functions.resize(MaxThreads, RunReader<StressUnit<0>>);
+		}
+
+		const size_t writers = (mode == 2) ? 2 : 1;
+		const double rate = Run(functions, milliseconds, results, writers);
+		uint64_t writes = 0;
+		for (size_t i = 0; i < writers; i++)
+		{
+			writes += results[i].Operations;
+		}
+		failures += GetFailures(results, MaxThreads);
+
+		printf("\t%s\treads %.0f/s\twrites %.0f/s\tfailed reads %llu\n",
+			modeNames[mode], rate,
+			(writes * 1000.0) / milliseconds,
+			(unsigned long long)GetFailures(results, MaxThreads));
+	}
+
+	printf("Devices, two threads on their own selected device\n");
+	failures += RunDevices(100000);
+
+	printf("Deferred, producer thread as the ISR, main thread as consumer\n");
+	failures += RunDeferred(milliseconds);
+
+	printf("%s\n", (failures == 0) ? "Passed." : "Failed.");
+
+	return (failures == 0) ? 0 : 1;
+}
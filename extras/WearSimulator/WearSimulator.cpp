@@ -0,0 +1,368 @@
+/*
+	Wear Simulator.
+	Host tool, replays an EEPROM_TRACE export or a synthetic workload
+	 against TemplateStorageAttributor layouts.
+	Reports per-byte wear, projected time to first failure and total simulated write time.
+
+	Recorded layout must match the traced firmware's layout.
+	Alternative layouts are re-run with the same logical writes, for "what if" comparisons.
+	Only StorageUnit and WearLevelUnit slot writes are replayed on alternative layouts.
+
+	Build:
+		g++ -std=c++11 -I../../src WearSimulator.cpp -o WearSimulator
+
+	Usage:
+		WearSimulator <trace.txt>
+		WearSimulator --synthetic <days> <key>=<writes per day>...
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+
+#include <StorageAttributor.h>
+#include <EmbeddedStorageBase\EmbeddedDeviceProfile.h>
+
+using SimulatedProfile = DeviceProfileATmega328P;
+
+template<const uint32_t key, typename DataType, typename WearLevelType, const WearLevelType option>
+struct SimulatedDefinition
+{
+	static constexpr uint16_t Size = sizeof(DataType);
+	static constexpr uint32_t Key = key;
+	static constexpr WearLevelType WearLevelOption = option;
+};
+
+// Edit to match the traced firmware.
+using RecordedLayout = TemplateStorageAttributor<
+	SimulatedDefinition<100001, uint8_t, NoWearLevel, NoWearLevel::x1>,
+	SimulatedDefinition<100002, uint16_t, WearLevelTiny, WearLevelTiny::x5>,
+	SimulatedDefinition<100003, uint32_t, WearLevelTiny, WearLevelTiny::x9>>;
+
+// Same Keys, alternative wear level options.
+using AlternativeLayout = TemplateStorageAttributor<
+	SimulatedDefinition<100001, uint8_t, NoWearLevel, NoWearLevel::x1>,
+	SimulatedDefinition<100002, uint16_t, WearLevelTiny, WearLevelTiny::x5>,
+	SimulatedDefinition<100003, uint32_t, WearLevelLong, WearLevelLong::x33>>;
+
+static constexpr uint64_t MillisPerDay = 86400000;
+
+struct UnitModel
+{
+	uint32_t Key;
+	uint32_t Address;
+	uint32_t Size;
+	uint32_t SlotSize;
+	uint8_t Levels;
+	uint8_t CounterSize;
+	uint8_t Counter;
+	uint64_t Writes;
+};
+
+/// <summary>
+/// Run-time unit models, from a TemplateStorageAttributor's definitions.
+/// </summary>
+template<typename Attributor>
+struct LayoutModel;
+
+template<typename... Definitions>
+struct LayoutModel<TemplateStorageAttributor<Definitions...>>
+{
+	using Attributor = TemplateStorageAttributor<Definitions...>;
+
+	template<typename Definition>
+	static UnitModel GetUnit()
+	{
+		UnitModel unit{};
+
+		unit.Key = Definition::Key;
+		unit.Address = Attributor::GetAddressByKey(Definition::Key);
+		unit.Size = Attributor::GetSizeByKey(Definition::Key);
+		unit.SlotSize = EmbeddedStorage::GetStorageSize(Definition::Size, NoWearLevel::x1, StorageParameter::GetErrorCorrection<Definition>());
+		unit.Levels = (uint8_t)Definition::WearLevelOption;
+		unit.CounterSize = (unit.Levels > 1) ? EmbeddedStorage::GetWearLevelCounterSize(unit.Levels) : 0;
+
+		return unit;
+	}
+
+	static std::vector<UnitModel> GetUnits()
+	{
+		return std::vector<UnitModel>{ GetUnit<Definitions>()... };
+	}
+};
+
+struct LogicalWrite
+{
+	uint32_t Key;
+	uint32_t Timestamp;
+};
+
+/// <summary>
+/// Byte level wear model of a layout.
+/// Erase cycles are counted per byte, write only programming is counted separately.
+/// Slot writes assume every byte changed, the worst case.
+/// </summary>
+class WearModel
+{
+public:
+	std::vector<UnitModel> Units;
+	std::vector<uint32_t> Cycles;
+	std::vector<uint32_t> Programs;
+	uint64_t Micros = 0;
+	uint64_t Unknown = 0;
+
+public:
+	WearModel(const std::vector<UnitModel>& units)
+		: Units(units)
+		, Cycles(SimulatedProfile::Capacity, 0)
+		, Programs(SimulatedProfile::Capacity, 0)
+	{
+	}
+
+	void Apply(const char operation, const uint32_t address)
+	{
+		if (address >= SimulatedProfile::Capacity)
+		{
+			Unknown++;
+			return;
+		}
+
+		switch (operation)
+		{
+		case 'W':
+			Cycles[address]++;
+			Micros += SimulatedProfile::ReadMicros + SimulatedProfile::EraseWriteMicros;
+			break;
+		case 'E':
+			Cycles[address]++;
+			Micros += SimulatedProfile::EraseMicros;
+			break;
+		case 'P':
+			Programs[address]++;
+			Micros += SimulatedProfile::WriteMicros;
+			break;
+		default:
+			break;
+		}
+	}
+
+	UnitModel* FindByKey(const uint32_t key)
+	{
+		for (size_t i = 0; i < Units.size(); i++)
+		{
+			if (Units[i].Key == key)
+			{
+				return &Units[i];
+			}
+		}
+
+		return nullptr;
+	}
+
+	UnitModel* FindByAddress(const uint32_t address)
+	{
+		for (size_t i = 0; i < Units.size(); i++)
+		{
+			if (address >= Units[i].Address && address < (Units[i].Address + Units[i].Size))
+			{
+				return &Units[i];
+			}
+		}
+
+		return nullptr;
+	}
+
+	/// <summary>
+	/// Same operations as StorageEngine::IncrementCounter() and WriteSlot().
+	/// </summary>
+	void Write(const uint32_t key)
+	{
+		UnitModel* unit = FindByKey(key);
+
+		if (unit == nullptr)
+		{
+			Unknown++;
+			return;
+		}
+
+		unit->Writes++;
+
+		if (unit->Levels > 1)
+		{
+			if (unit->Counter + 1 >= unit->Levels)
+			{
+				unit->Counter = 0;
+				for (uint8_t i = 0; i < unit->CounterSize; i++)
+				{
+					Apply('E', unit->Address + i);
+				}
+			}
+			else
+			{
+				unit->Counter++;
+				Apply('P', unit->Address + unit->CounterSize - 1 - ((unit->Counter - 1) / 8));
+			}
+		}
+
+		const uint32_t slotAddress = unit->Address + unit->CounterSize + ((uint32_t)unit->Counter * unit->SlotSize);
+		for (uint32_t i = 0; i < unit->SlotSize; i++)
+		{
+			Apply('W', slotAddress + i);
+		}
+	}
+
+	void Report(const char* name, const uint64_t durationMillis)
+	{
+		uint32_t worstAddress = 0;
+		for (uint32_t i = 0; i < Cycles.size(); i++)
+		{
+			if (Cycles[i] > Cycles[worstAddress])
+			{
+				worstAddress = i;
+			}
+		}
+
+		printf("%s\n", name);
+		for (size_t i = 0; i < Units.size(); i++)
+		{
+			printf("\tKey %u @ %u\t(%u bytes, x%u)\t%llu writes\n",
+				Units[i].Key, Units[i].Address, Units[i].Size, Units[i].Levels, (unsigned long long)Units[i].Writes);
+		}
+
+		const UnitModel* worstUnit = FindByAddress(worstAddress);
+		printf("\tWorst byte @ %u (Key %u)\t%u cycles, %u programs\n",
+			worstAddress, (worstUnit != nullptr) ? worstUnit->Key : 0, Cycles[worstAddress], Programs[worstAddress]);
+		printf("\tWrite time\t%llu ms\n", (unsigned long long)(Micros / 1000));
+
+		if (Cycles[worstAddress] > 0 && durationMillis > 0)
+		{
+			const double cyclesPerDay = (double)Cycles[worstAddress] * MillisPerDay / durationMillis;
+			printf("\tFirst failure in\t%.0f days\n", SimulatedProfile::EnduranceCycles / cyclesPerDay);
+		}
+		else
+		{
+			printf("\tFirst failure in\tn/a\n");
+		}
+
+		if (Unknown > 0)
+		{
+			printf("\tUnmapped operations\t%llu\n", (unsigned long long)Unknown);
+		}
+		printf("\n");
+	}
+};
+
+static int ReplayTrace(const char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (file == nullptr)
+	{
+		printf("Cannot open %s\n", path);
+		return 1;
+	}
+
+	WearModel recorded(LayoutModel<RecordedLayout>::GetUnits());
+	std::vector<LogicalWrite> writes;
+	uint32_t first = 0;
+	uint32_t last = 0;
+	bool started = false;
+	char line[64];
+
+	while (fgets(line, sizeof(line), file) != nullptr)
+	{
+		char operation = 0;
+		unsigned long address = 0;
+		unsigned long timestamp = 0;
+
+		if (line[0] == '#'
+			|| sscanf(line, "%c,%lu,%lu", &operation, &address, &timestamp) != 3)
+		{
+			continue;
+		}
+
+		if (!started)
+		{
+			first = timestamp;
+			started = true;
+		}
+		last = timestamp;
+
+		if (operation == 'S')
+		{
+			UnitModel* unit = recorded.FindByAddress(address);
+			if (unit != nullptr)
+			{
+				unit->Writes++;
+				writes.push_back(LogicalWrite{ unit->Key, (uint32_t)timestamp });
+			}
+		}
+		else
+		{
+			recorded.Apply(operation, address);
+		}
+	}
+	fclose(file);
+
+	const uint64_t duration = last - first;
+
+	recorded.Report("Recorded (measured)", duration);
+
+	WearModel alternative(LayoutModel<AlternativeLayout>::GetUnits());
+	for (size_t i = 0; i < writes.size(); i++)
+	{
+		alternative.Write(writes[i].Key);
+	}
+	alternative.Report("Alternative (replayed)", duration);
+
+	return 0;
+}
+
+static int RunSynthetic(const int argc, char** argv)
+{
+	const uint32_t days = strtoul(argv[2], nullptr, 10);
+
+	WearModel recorded(LayoutModel<RecordedLayout>::GetUnits());
+	WearModel alternative(LayoutModel<AlternativeLayout>::GetUnits());
+
+	for (int i = 3; i < argc; i++)
+	{
+		const char* separator = strchr(argv[i], '=');
+		if (separator == nullptr)
+		{
+			printf("Invalid workload %s, expected <key>=<writes per day>\n", argv[i]);
+			return 1;
+		}
+
+		const uint32_t key = strtoul(argv[i], nullptr, 10);
+		const uint64_t count = (uint64_t)strtoul(separator + 1, nullptr, 10) * days;
+
+		for (uint64_t j = 0; j < count; j++)
+		{
+			recorded.Write(key);
+			alternative.Write(key);
+		}
+	}
+
+	recorded.Report("Recorded (synthetic)", days * MillisPerDay);
+	alternative.Report("Alternative (synthetic)", days * MillisPerDay);
+
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc >= 3 && strcmp(argv[1], "--synthetic") == 0)
+	{
+		return RunSynthetic(argc, argv);
+	}
+	else if (argc == 2)
+	{
+		return ReplayTrace(argv[1]);
+	}
+
+	printf("Usage:\n\tWearSimulator <trace.txt>\n\tWearSimulator --synthetic <days> <key>=<writes per day>...\n");
+
+	return 1;
+}
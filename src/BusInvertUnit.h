@@ -0,0 +1,75 @@
+#ifndef _BUS_INVERT_UNIT_
+#define _BUS_INVERT_UNIT_
+
+#include "EmbeddedStorageBase\EmbeddedEEPROM.h"
+#include "EmbeddedStorageBase\StorageEngine.h"
+#include <EmbeddedStorage.h>
+
+/// <summary>
+/// CRC checked EEPROM storage unit, with bus-invert encoding.
+/// ||Data...|CRC|Flags...||
+/// Each Data and CRC block is stored as-is or inverted, with a flag bit,
+///  whichever needs fewer erases over the byte already stored.
+/// Blocks are written with the cheapest mode: skipped, write-only (zeros programmed) or erase and write.
+/// Values that toggle back and forth are mostly written without erasing.
+/// </summary>
+/// <param name="DataSize">Data size in bytes.</param>
+/// <param name="Key">Storage cryptographic salt key.
+///  Changing the key invalidates any previous data.</param>
+template<const StorageAddress address,
+	const uint16_t DataSize,
+	const uint32_t Key = DataSize>
+class BusInvertStorageUnit
+{
+private:
+	static_assert(EmbeddedStorage::Fits(address, EmbeddedStorage::GetStorageSpan(DataSize, NoWearLevel::x1) + StorageEngine::GetInvertFlagsSize(DataSize)), "Unit exceeds the StorageAddress range, enable EEPROM_ADDRESS_32.");
+
+public:
+	static constexpr StorageAddress Address()
+	{
+		return address;
+	}
+
+	static constexpr StorageAddress Size()
+	{
+		return EmbeddedStorage::GetStorageSize(DataSize) + StorageEngine::GetInvertFlagsSize(DataSize);
+	}
+
+	/// <summary>
+	/// Declared data size in bytes, for wrappers.
+	/// </summary>
+	static constexpr uint16_t GetDataSize()
+	{
+		return DataSize;
+	}
+
+public:
+	/// <summary>
+	/// Prepares the EEPROM backend.
+	/// Construction has no side effects, call once from setup().
+	/// </summary>
+	void Begin()
+	{
+		EEPROM.begin();
+	}
+
+	/// <summary>
+	/// Reads and decodes the declared DataSize into target array.
+	/// </summary>
+	/// <param name="target">Target array.</param>
+	/// <returns>True if CRC matches.</returns>
+	const bool ReadData(uint8_t* target)
+	{
+		return StorageEngine::ReadInvertSlot(address, target, DataSize, Key, 0);
+	}
+
+	/// <summary>
+	/// Encodes and writes the declared DataSize from source array.
+	/// </summary>
+	/// <param name="source">Source array.</param>
+	void WriteData(const uint8_t* source)
+	{
+		StorageEngine::WriteInvertSlot(address, source, DataSize, Key, 0);
+	}
+};
+#endif
@@ -0,0 +1,203 @@
+#ifndef _CHUNKED_UNIT_
+#define _CHUNKED_UNIT_
+
+#include "EmbeddedStorageBase\EmbeddedEEPROM.h"
+#include "EmbeddedStorageBase\StorageEngine.h"
+#include <EmbeddedStorage.h>
+
+/// <summary>
+/// CRC checked EEPROM storage unit, split into fixed size chunks with one CRC each.
+/// ||Chunk0...|CRC0||Chunk1...|CRC1||...||
+/// WriteRange() only reprograms the touched chunks and their CRCs, for partial updates of large tables.
+/// Reads validate each chunk and report which chunks are invalid.
+/// Each chunk's CRC is salted with its index.
+/// </summary>
+/// <param name="DataSize">Data size in bytes.</param>
+/// <param name="ChunkSize">Chunk size in bytes, the last chunk may be shorter.</param>
+/// <param name="Key">Storage cryptographic salt key.
+///  Changing the key invalidates any previous data.</param>
+template<const StorageAddress address,
+	const uint16_t DataSize,
+	const uint8_t ChunkSize,
+	const uint32_t Key = DataSize>
+class ChunkedStorageUnit
+{
+public:
+	static constexpr uint16_t ChunkCount = (DataSize + ChunkSize - 1) / ChunkSize;
+
+private:
+	static_assert(ChunkSize > 0 && DataSize > 0, "ChunkSize and DataSize must be at least 1.");
+	static_assert(ChunkCount <= ((uint16_t)UINT8_MAX + 1), "At most 256 chunks, increase the ChunkSize.");
+	static_assert(EmbeddedStorage::Fits(address, (uint32_t)DataSize + ChunkCount), "Unit exceeds the StorageAddress range, enable EEPROM_ADDRESS_32.");
+
+	static constexpr uint16_t ChunkStride = (uint16_t)ChunkSize + 1;
+
+public:
+	static constexpr StorageAddress Address()
+	{
+		return address;
+	}
+
+	static constexpr StorageAddress Size()
+	{
+		return DataSize + ChunkCount;
+	}
+
+	/// <summary>
+	/// Declared data size in bytes, for wrappers.
+	/// </summary>
+	static constexpr uint16_t GetDataSize()
+	{
+		return DataSize;
+	}
+
+	/// <summary>
+	/// Chunk error mask size in bytes, one bit per chunk.
+	/// </summary>
+	static constexpr uint8_t GetErrorMaskSize()
+	{
+		return (ChunkCount + 7) / 8;
+	}
+
+public:
+	/// <summary>
+	/// Prepares the EEPROM backend.
+	/// Construction has no side effects, call once from setup().
+	/// </summary>
+	void Begin()
+	{
+		EEPROM.begin();
+	}
+
+	/// <summary>
+	/// Reads the declared DataSize into target array.
+	/// </summary>
+	/// <param name="target">Target array.</param>
+	/// <returns>True if all chunk CRCs match.</returns>
+	const bool ReadData(uint8_t* target)
+	{
+		bool valid = true;
+
+		for (uint16_t i = 0; i < ChunkCount; i++)
+		{
+			valid &= ReadChunk(i, target);
+		}
+
+		return valid;
+	}
+
+	/// <summary>
+	/// Reads the declared DataSize into target array.
+	/// Invalid chunks are flagged in errorMask, bit (index % 8) of byte (index / 8).
+	/// </summary>
+	/// <param name="target">Target array.</param>
+	/// <param name="errorMask">Chunk error mask, with GetErrorMaskSize() bytes.</param>
+	/// <returns>True if all chunk CRCs match.</returns>
+	const bool ReadData(uint8_t* target, uint8_t* errorMask)
+	{
+		bool valid = true;
+
+		for (uint8_t i = 0; i < GetErrorMaskSize(); i++)
+		{
+			errorMask[i] = 0;
+		}
+
+		for (uint16_t i = 0; i < ChunkCount; i++)
+		{
+			if (!ReadChunk(i, target))
+			{
+				errorMask[i / 8] |= (uint8_t)(1 << (i % 8));
+				valid = false;
+			}
+		}
+
+		return valid;
+	}
+
+	/// <summary>
+	/// Reads a single chunk into its place in target array.
+	/// </summary>
+	/// <param name="index">Chunk index.</param>
+	/// <param name="target">Target array, with DataSize bytes.</param>
+	/// <returns>True if the chunk CRC matches.</returns>
+	const bool ReadChunk(const uint16_t index, uint8_t* target)
+	{
+		return (index < ChunkCount)
+			&& StorageEngine::ReadSlot(GetChunkAddress(index), &target[index * ChunkSize], GetChunkSize(index), Key, (uint8_t)index);
+	}
+
+	/// <summary>
+	/// Writes the declared DataSize from source array.
+	/// </summary>
+	/// <param name="source">Source array.</param>
+	void WriteData(const uint8_t* source)
+	{
+		for (uint16_t i = 0; i < ChunkCount; i++)
+		{
+			StorageEngine::WriteSlot(GetChunkAddress(i), &source[i * ChunkSize], GetChunkSize(i), Key, (uint8_t)i);
+		}
+	}
+
+	/// <summary>
+	/// Writes length bytes at data offset, reprogramming only the touched chunks and their CRCs.
+	/// Partially covered chunks are read back and validated first,
+	///  an invalid one is left as is, to not re-sign corrupted data.
+	/// </summary>
+	/// <param name="offset">Data offset.</param>
+	/// <param name="length">Number of bytes.</param>
+	/// <param name="source">Source array, with length bytes.</param>
+	/// <returns>False if out of range or a partially covered chunk was invalid.</returns>
+	const bool WriteRange(const uint16_t offset, const uint16_t length, const uint8_t* source)
+	{
+		if (length == 0 || ((uint32_t)offset + length) > DataSize)
+		{
+			return false;
+		}
+
+		const uint16_t first = offset / ChunkSize;
+		const uint16_t last = (offset + length - 1) / ChunkSize;
+		uint8_t chunk[ChunkSize];
+		bool valid = true;
+
+		for (uint16_t i = first; i <= last; i++)
+		{
+			const uint16_t chunkStart = i * ChunkSize;
+			const uint8_t chunkSize = GetChunkSize(i);
+
+			if (offset > chunkStart
+				|| (offset + length) < (chunkStart + chunkSize))
+			{
+				if (!StorageEngine::ReadSlot(GetChunkAddress(i), chunk, chunkSize, Key, (uint8_t)i))
+				{
+					valid = false;
+					continue;
+				}
+			}
+
+			for (uint8_t j = 0; j < chunkSize; j++)
+			{
+				if ((chunkStart + j) >= offset
+					&& (chunkStart + j) < (offset + length))
+				{
+					chunk[j] = source[chunkStart + j - offset];
+				}
+			}
+
+			StorageEngine::WriteSlot(GetChunkAddress(i), chunk, chunkSize, Key, (uint8_t)i);
+		}
+
+		return valid;
+	}
+
+private:
+	static constexpr StorageAddress GetChunkAddress(const uint16_t index)
+	{
+		return address + ((StorageAddress)index * ChunkStride);
+	}
+
+	static constexpr uint8_t GetChunkSize(const uint16_t index)
+	{
+		return (index < (ChunkCount - 1)) ? ChunkSize : (uint8_t)(DataSize - ((ChunkCount - 1) * ChunkSize));
+	}
+};
+#endif
@@ -0,0 +1,191 @@
+#ifndef _COMPRESSED_UNIT_
+#define _COMPRESSED_UNIT_
+
+#include "EmbeddedStorageBase\EmbeddedEEPROM.h"
+#include "EmbeddedStorageBase\EmbeddedCrc.h"
+#include "EmbeddedStorageBase\EmbeddedCodec.h"
+#include <EmbeddedStorage.h>
+
+/// <summary>
+/// Compressed slot layout, shared by compressed units.
+/// Data is Delta+RLE encoded, only the encoded bytes are programmed.
+/// CRC is calculated over the decoded data.
+/// ||Length|Encoded...|CRC||
+/// </summary>
+/// <param name="DataSize">Decoded data size in bytes.</param>
+/// <param name="Key">Storage cryptographic salt key.</param>
+template<const uint16_t DataSize,
+	const uint32_t Key>
+class CompressedSlot
+{
+public:
+	/// <summary>
+	/// Compile-time worst case slot data size, without CRC.
+	/// </summary>
+	static constexpr uint16_t SlotSize = DeltaRleCodec::GetSlotSize(DataSize);
+
+protected:
+	static const bool ReadSlot(const StorageAddress slotAddress, uint8_t* target, const uint8_t salt = 0)
+	{
+		EmbeddedCrc<Key> crc{};
+		const uint16_t length = ((uint16_t)EmbeddedEEPROM::ReadBlock(slotAddress + 1) << 8)
+			| EmbeddedEEPROM::ReadBlock(slotAddress);
+
+		if (length > DeltaRleCodec::GetMaxEncodedSize(DataSize)
+			|| !DeltaRleCodec::Decode(slotAddress + sizeof(uint16_t), length, target, DataSize))
+		{
+			return false;
+		}
+
+		return crc.GetCrc(target, DataSize, salt) == EmbeddedEEPROM::ReadBlock(slotAddress + SlotSize);
+	}
+
+	static void WriteSlot(const StorageAddress slotAddress, const uint8_t* source, const uint8_t salt = 0)
+	{
+		EmbeddedCrc<Key> crc{};
+		const uint16_t length = DeltaRleCodec::Encode(slotAddress + sizeof(uint16_t), source, DataSize);
+
+		EmbeddedEEPROM::WriteBlock(slotAddress, length & UINT8_MAX);
+		EmbeddedEEPROM::WriteBlock(slotAddress + 1, length >> 8);
+		EmbeddedEEPROM::WriteBlock(slotAddress + SlotSize, crc.GetCrc(source, DataSize, salt));
+	}
+};
+
+/// <summary>
+/// Compressed, CRC checked EEPROM storage unit.
+/// Designed for large tables with zero runs and slowly varying values.
+/// EEPROM space is reserved for the worst case, use CompressedSlot::SlotSize for attribution.
+/// </summary>
+/// <param name="DataSize">Data size in bytes.</param>
+/// <param name="Key">Storage cryptographic salt key.
+///  Changing the key invalidates any previous data.</param>
+template<const StorageAddress address,
+	const uint16_t DataSize,
+	const uint32_t Key = DataSize>
+class CompressedStorageUnit : public CompressedSlot<DataSize, Key>
+{
+private:
+	using BaseClass = CompressedSlot<DataSize, Key>;
+
+	static_assert(EmbeddedStorage::Fits(address, EmbeddedStorage::GetStorageSpan(BaseClass::SlotSize, NoWearLevel::x1)), "Unit exceeds the StorageAddress range, enable EEPROM_ADDRESS_32.");
+
+public:
+	static constexpr StorageAddress Address()
+	{
+		return address;
+	}
+
+	static constexpr StorageAddress Size()
+	{
+		return EmbeddedStorage::GetStorageSize(BaseClass::SlotSize);
+	}
+
+	/// <summary>
+	/// Declared data size in bytes, for wrappers.
+	/// </summary>
+	static constexpr uint16_t GetDataSize()
+	{
+		return DataSize;
+	}
+
+public:
+	CompressedStorageUnit() : BaseClass()
+	{}
+
+	/// <summary>
+	/// Prepares the EEPROM backend.
+	/// Construction has no side effects, call once from setup().
+	/// </summary>
+	void Begin()
+	{
+		EEPROM.begin();
+	}
+
+	/// <summary>
+	/// Reads and decodes the declared DataSize into target array.
+	/// </summary>
+	/// <param name="target">Target array.</param>
+	/// <returns>True if decoded and CRC matches.</returns>
+	const bool ReadData(uint8_t* target)
+	{
+		return BaseClass::ReadSlot(address, target);
+	}
+
+	/// <summary>
+	/// Encodes and writes the declared DataSize from source array.
+	/// </summary>
+	/// <param name="source">Source array.</param>
+	void WriteData(const uint8_t* source)
+	{
+		BaseClass::WriteSlot(address, source);
+	}
+};
+
+/// <summary>
+/// Compressed, wear levelled, CRC checked EEPROM storage unit.
+/// Wraps a WearLevelUnit declared with DataSize = CompressedSlot::SlotSize.
+/// The wrapped unit is private, its slot level members (Verify, ReadVersion, ReadCommitted, ...)
+///  would operate on the encoded slot. Only the decoded Begin/ReadData/WriteData are exposed.
+/// Example:
+///  CompressedWearLevelUnit<TinyWearLevelUnit<0, DeltaRleCodec::GetSlotSize(200), WearLevelTiny::x4>, 200>
+/// </summary>
+/// <typeparam name="WearLevelUnitType">Tiny/Short/Long/LongLong WearLevelUnit.</typeparam>
+/// <param name="DataSize">Data size in bytes.</param>
+/// <param name="Key">Storage cryptographic salt key.
+///  Changing the key invalidates any previous data.</param>
+template<typename WearLevelUnitType,
+	const uint16_t DataSize,
+	const uint32_t Key = DataSize>
+class CompressedWearLevelUnit
+	: private WearLevelUnitType
+	, private CompressedSlot<DataSize, Key>
+{
+private:
+	using SlotClass = CompressedSlot<DataSize, Key>;
+
+	static_assert((WearLevelUnitType::GetSlotAddress(1) - WearLevelUnitType::GetSlotAddress(0))
+		== EmbeddedStorage::GetStorageSize(SlotClass::SlotSize), "WearLevelUnitType must be declared with DataSize = CompressedSlot::SlotSize.");
+
+public:
+	using WearLevelUnitType::Address;
+	using WearLevelUnitType::Size;
+	using WearLevelUnitType::GetCounterSize;
+	using WearLevelUnitType::Begin;
+
+public:
+	CompressedWearLevelUnit() : WearLevelUnitType(), SlotClass()
+	{}
+
+	/// <summary>
+	/// Decoded data size in bytes, the wrapped unit's DataSize is the slot size.
+	/// </summary>
+	static constexpr uint16_t GetDataSize()
+	{
+		return DataSize;
+	}
+
+	/// <summary>
+	/// Reads and decodes the declared DataSize into target array.
+	/// </summary>
+	/// <param name="target">Target array.</param>
+	/// <returns>True if decoded and CRC matches.</returns>
+	const bool ReadData(uint8_t* target)
+	{
+		const uint8_t counter = this->GetCurrentCounter();
+
+		return SlotClass::ReadSlot(WearLevelUnitType::GetSlotAddress(counter), target, counter);
+	}
+
+	/// <summary>
+	/// Encodes and writes the declared DataSize from source array.
+	/// </summary>
+	/// <param name="source">Source array.</param>
+	void WriteData(const uint8_t* source)
+	{
+		const uint8_t counter = this->GetNextCounter();
+
+		SlotClass::WriteSlot(WearLevelUnitType::GetSlotAddress(counter), source, counter);
+		this->CommitCounter(counter);
+	}
+};
+#endif
@@ -0,0 +1,224 @@
+#ifndef _COUNTER_UNIT_
+#define _COUNTER_UNIT_
+
+#include "EmbeddedStorageBase\EmbeddedEEPROM.h"
+#include "EmbeddedStorageBase\StorageEngine.h"
+#include <EmbeddedStorage.h>
+
+/// <summary>
+/// Monotonic counter unit, i.e. for boot counts, runtime hours or usage tallies.
+/// ||Record0|Record1|Tally...||
+/// Value is the newest valid base record plus the number of programmed tally bits.
+/// Increment() programs a single tally bit, a write-only byte operation.
+/// Every TallySize x 8 increments, the base is committed to the older record and the tally is erased,
+///  so erase wear is divided by the tally bit count.
+/// Each record is ||Base|Sequence|CRC|Cleared||, ping-ponged for power loss safety.
+/// Cleared is programmed to zero after the tally erase, an interrupted erase is completed on Begin().
+/// </summary>
+/// <param name="TallySize">Tally size in bytes, from 1 to 8.</param>
+/// <param name="Key">Storage cryptographic salt key.
+///  Changing the key invalidates any previous data.</param>
+template<const StorageAddress address,
+	const uint8_t TallySize = 4,
+	const uint32_t Key = TallySize>
+class CounterUnit
+{
+private:
+	static_assert(TallySize >= 1 && TallySize <= 8, "TallySize must be from 1 to 8.");
+
+	struct BaseRecord
+	{
+		uint32_t Base;
+		uint8_t Sequence;
+	};
+
+	static constexpr uint16_t RecordDataSize = sizeof(uint32_t) + sizeof(uint8_t);
+	static constexpr uint16_t ClearedOffset = RecordDataSize + 1;
+	static constexpr uint16_t RecordStride = ClearedOffset + 1;
+	static constexpr StorageAddress TallyAddress = address + (2 * RecordStride);
+
+	static constexpr uint8_t TallyBits = TallySize * 8;
+
+	static_assert(EmbeddedStorage::Fits(address, (2 * RecordStride) + TallySize), "Unit exceeds the StorageAddress range, enable EEPROM_ADDRESS_32.");
+
+public:
+	static constexpr StorageAddress Address()
+	{
+		return address;
+	}
+
+	static constexpr StorageAddress Size()
+	{
+		return (2 * RecordStride) + TallySize;
+	}
+
+	/// <summary>
+	/// Increments between base commits.
+	/// </summary>
+	static constexpr uint8_t GetTallyBits()
+	{
+		return TallyBits;
+	}
+
+public:
+	/// <summary>
+	/// Completes an interrupted commit, or initializes the counter to 0 on first use.
+	/// Construction has no side effects, call once from setup().
+	/// </summary>
+	void Begin()
+	{
+		EEPROM.begin();
+
+		BaseRecord record{};
+		uint8_t index = 0;
+		if (!GetNewestRecord(record, index))
+		{
+			Commit(0);
+		}
+		else if (EmbeddedEEPROM::ReadBlock(GetRecordAddress(index) + ClearedOffset) != 0)
+		{
+			ClearTally(index);
+		}
+	}
+
+	/// <summary>
+	/// Current counter value.
+	/// </summary>
+	const uint32_t Get()
+	{
+		BaseRecord record{};
+		uint8_t index = 0;
+		GetNewestRecord(record, index);
+
+		return record.Base + GetTally();
+	}
+
+	/// <summary>
+	/// Increments the counter by 1.
+	/// Programs a single tally bit, unless the tally is full and the base is committed first.
+	/// </summary>
+	/// <returns>Counter value after the increment.</returns>
+	const uint32_t Increment()
+	{
+		BaseRecord record{};
+		uint8_t index = 0;
+		GetNewestRecord(record, index);
+
+		uint8_t tally = GetTally();
+		if (tally >= TallyBits)
+		{
+			record.Base += tally;
+			Commit(record.Base);
+			tally = 0;
+		}
+
+		StorageEngine::IncrementCounter(TallyAddress, TallySize, TallyBits + 1);
+
+		return record.Base + tally + 1;
+	}
+
+	/// <summary>
+	/// Sets the counter value, with a base commit and tally erase.
+	/// </summary>
+	void Set(const uint32_t value)
+	{
+		Commit(value);
+	}
+
+private:
+	static constexpr StorageAddress GetRecordAddress(const uint8_t index)
+	{
+		return address + (index * RecordStride);
+	}
+
+	static const uint8_t GetTally()
+	{
+		return StorageEngine::GetCounter(TallyAddress, TallySize, TallyBits + 1);
+	}
+
+	/// <summary>
+	/// Newest valid record, by wrapping sequence.
+	/// </summary>
+	/// <returns>False if neither record is valid.</returns>
+	static const bool GetNewestRecord(BaseRecord& record, uint8_t& index)
+	{
+		BaseRecord records[2]{};
+		bool valid[2]{};
+
+		for (uint8_t i = 0; i < 2; i++)
+		{
+			valid[i] = ReadRecord(i, records[i]);
+		}
+
+		if (valid[0] && valid[1])
+		{
+			index = ((int8_t)(records[1].Sequence - records[0].Sequence) > 0) ? 1 : 0;
+		}
+		else if (valid[0] || valid[1])
+		{
+			index = valid[1] ? 1 : 0;
+		}
+		else
+		{
+			record = BaseRecord{};
+			index = 0;
+
+			return false;
+		}
+
+		record = records[index];
+
+		return true;
+	}
+
+	static const bool ReadRecord(const uint8_t index, BaseRecord& record)
+	{
+		uint8_t data[RecordDataSize];
+
+		if (!StorageEngine::ReadSlot(GetRecordAddress(index), data, RecordDataSize, Key, index))
+		{
+			return false;
+		}
+
+		record.Base = (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+		record.Sequence = data[4];
+
+		return true;
+	}
+
+	/// <summary>
+	/// Writes the base to the older record, then erases the tally.
+	/// </summary>
+	static void Commit(const uint32_t base)
+	{
+		BaseRecord record{};
+		uint8_t index = 0;
+		const bool valid = GetNewestRecord(record, index);
+
+		const uint8_t target = valid ? (index ^ 1) : 0;
+		const uint8_t sequence = valid ? (uint8_t)(record.Sequence + 1) : 0;
+		const uint8_t data[RecordDataSize] = { (uint8_t)base, (uint8_t)(base >> 8), (uint8_t)(base >> 16), (uint8_t)(base >> 24), sequence };
+
+		EmbeddedEEPROM::WriteBlock(GetRecordAddress(target) + ClearedOffset, UINT8_MAX);
+		StorageEngine::WriteSlot(GetRecordAddress(target), data, RecordDataSize, Key, target);
+		ClearTally(target);
+	}
+
+	/// <summary>
+	/// Erases the tally, most significant byte first so an interrupted erase is never unary,
+	///  then programs the record's Cleared marker.
+	/// </summary>
+	static void ClearTally(const uint8_t index)
+	{
+		for (uint8_t i = TallySize; i > 0; i--)
+		{
+			if (EmbeddedEEPROM::ReadBlock(TallyAddress + i - 1) != UINT8_MAX)
+			{
+				EmbeddedEEPROM::ClearByteToOnes(TallyAddress + i - 1);
+			}
+		}
+
+		EmbeddedEEPROM::ProgramZeroBitsToZero(GetRecordAddress(index) + ClearedOffset, 0);
+	}
+};
+#endif
@@ -0,0 +1,56 @@
+#ifndef _DEFAULTED_UNIT_
+#define _DEFAULTED_UNIT_
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+/// <summary>
+/// Unit with a compile-time default value, stored in PROGMEM.
+/// Reading an invalid or never written unit returns the default, with no EEPROM write.
+/// EEPROM is only written on the first WriteData(), don't write the default back on boot.
+/// Invalidate() is a factory reset: only the CRC byte is written, reads return the default again.
+/// const Settings SettingsDefault PROGMEM = { 128, 300 };
+/// DefaultedUnit<StorageUnit<0, sizeof(Settings)>, Settings, SettingsDefault> unit{};
+/// </summary>
+/// <typeparam name="UnitType">StorageUnit or a WearLevelUnit, with DataSize = sizeof(DataType).</typeparam>
+/// <typeparam name="DataType">Data struct type.</typeparam>
+/// <param name="Default">Default value, in PROGMEM.</param>
+template<typename UnitType,
+	typename DataType,
+	const DataType& Default>
+class DefaultedUnit : public UnitType
+{
+private:
+	static_assert(UnitType::GetDataSize() == sizeof(DataType), "UnitType must be declared with DataSize = sizeof(DataType).");
+
+public:
+	DefaultedUnit() : UnitType()
+	{}
+
+	/// <summary>
+	/// Reads the stored data into target array, or the default if the stored data is invalid.
+	/// </summary>
+	/// <param name="target">Target array, of sizeof(DataType).</param>
+	/// <returns>True if CRC matches, false if target holds the default.</returns>
+	const bool ReadData(uint8_t* target)
+	{
+		if (UnitType::ReadData(target))
+		{
+			return true;
+		}
+
+		ReadDefault(target);
+
+		return false;
+	}
+
+	/// <summary>
+	/// Copies the default from PROGMEM into target array.
+	/// </summary>
+	/// <param name="target">Target array, of sizeof(DataType).</param>
+	static void ReadDefault(uint8_t* target)
+	{
+		memcpy_P(target, &Default, sizeof(DataType));
+	}
+};
+#endif
@@ -0,0 +1,196 @@
+#ifndef _DEFERRED_WRITE_QUEUE_
+#define _DEFERRED_WRITE_QUEUE_
+
+#include <stdint.h>
+
+// Orders shared queue accesses between producer and consumer.
+// AVR is single core, only the compiler must not reorder.
+// Elsewhere (i.e. host testing with a thread as the ISR), a full memory fence.
+#if defined(__AVR__)
+#define DEFERRED_WRITE_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define DEFERRED_WRITE_BARRIER() __sync_synchronize()
+#endif
+
+/// <summary>
+/// Lock-free single-producer/single-consumer queue of pending unit writes.
+/// The producer (i.e. an ISR) calls Enqueue(), which copies the payload and returns in O(1), with no EEPROM access.
+/// The consumer (main loop) calls Dequeue() or Drain() and performs the blocking unit writes.
+/// Each unit id has its own payload slot:
+///  - Repeated writes to a pending unit are coalesced, only the latest payload is written.
+///  - At most UnitCount writes are pending, so the queue never overflows.
+/// Payload slots are sequence locked, the consumer retries a copy interrupted by the producer.
+/// </summary>
+/// <param name="UnitCount">Number of unit ids, from 1 to 254.</param>
+/// <param name="PayloadSize">Payload size in bytes.</param>
+template<const uint8_t UnitCount,
+	const uint8_t PayloadSize>
+class DeferredWriteQueue
+{
+private:
+	static_assert(UnitCount > 0 && UnitCount < UINT8_MAX, "UnitCount must be from 1 to 254.");
+
+	static constexpr uint8_t RingSize = UnitCount + 1;
+
+private:
+	volatile uint8_t Payloads[UnitCount][PayloadSize];
+	volatile uint8_t Sequences[UnitCount];
+	volatile uint8_t Pending[UnitCount];
+
+	// Unit ids in enqueue order.
+	volatile uint8_t Ring[RingSize];
+	volatile uint8_t Head = 0;
+	volatile uint8_t Tail = 0;
+
+	volatile uint8_t Coalesced = 0;
+
+public:
+	DeferredWriteQueue()
+	{
+		for (uint8_t i = 0; i < UnitCount; i++)
+		{
+			Sequences[i] = 0;
+			Pending[i] = false;
+		}
+	}
+
+	static constexpr uint8_t GetUnitCount()
+	{
+		return UnitCount;
+	}
+
+	static constexpr uint8_t GetPayloadSize()
+	{
+		return PayloadSize;
+	}
+
+	/// <summary>
+	/// Producer side, safe to call from an ISR.
+	/// Replaces the payload of an already pending unit.
+	/// </summary>
+	/// <param name="id">Unit id, from 0 to UnitCount - 1.</param>
+	/// <param name="payload">Source array, with PayloadSize bytes.</param>
+	/// <returns>False if id is out of range.</returns>
+	const bool Enqueue(const uint8_t id, const uint8_t* payload)
+	{
+		if (id >= UnitCount)
+		{
+			return false;
+		}
+
+		Sequences[id]++;
+		DEFERRED_WRITE_BARRIER();
+		for (uint8_t i = 0; i < PayloadSize; i++)
+		{
+			Payloads[id][i] = payload[i];
+		}
+		DEFERRED_WRITE_BARRIER();
+		Sequences[id]++;
+		DEFERRED_WRITE_BARRIER();
+
+		if (Pending[id])
+		{
+			Coalesced++;
+		}
+		else
+		{
+			Pending[id] = true;
+			Ring[Head] = id;
+			DEFERRED_WRITE_BARRIER();
+			Head = GetNextIndex(Head);
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Consumer side, main loop only.
+	/// Takes the oldest pending write.
+	/// A unit enqueued again while being dequeued is pending again, with the latest payload.
+	/// </summary>
+	/// <param name="id">Unit id of the pending write.</param>
+	/// <param name="payload">Target array, with PayloadSize bytes.</param>
+	/// <returns>True if a write was pending.</returns>
+	const bool Dequeue(uint8_t& id, uint8_t* payload)
+	{
+		if (Tail == Head)
+		{
+			return false;
+		}
+
+		DEFERRED_WRITE_BARRIER();
+		id = Ring[Tail];
+		DEFERRED_WRITE_BARRIER();
+		Tail = GetNextIndex(Tail);
+
+		// Cleared before copying, so a newer payload is either copied now or enqueued again.
+		Pending[id] = false;
+		DEFERRED_WRITE_BARRIER();
+
+		uint8_t sequence;
+		do
+		{
+			sequence = Sequences[id];
+			DEFERRED_WRITE_BARRIER();
+			for (uint8_t i = 0; i < PayloadSize; i++)
+			{
+				payload[i] = Payloads[id][i];
+			}
+			DEFERRED_WRITE_BARRIER();
+		} while ((sequence & 1) || (sequence != Sequences[id]));
+
+		return true;
+	}
+
+	/// <summary>
+	/// Consumer side, main loop only.
+	/// Dequeues all pending writes into write, in enqueue order.
+	/// </summary>
+	/// <param name="write">Unit write function, i.e. routed by id to the unit's WriteData.</param>
+	/// <returns>Number of writes performed.</returns>
+	const uint8_t Drain(void (*write)(const uint8_t id, const uint8_t* payload))
+	{
+		uint8_t payload[PayloadSize];
+		uint8_t id = 0;
+		uint8_t count = 0;
+
+		while (Dequeue(id, payload))
+		{
+			write(id, payload);
+			count++;
+		}
+
+		return count;
+	}
+
+	const uint8_t GetPendingCount() const
+	{
+		const uint8_t head = Head;
+		const uint8_t tail = Tail;
+
+		if (head >= tail)
+		{
+			return head - tail;
+		}
+		else
+		{
+			return RingSize - tail + head;
+		}
+	}
+
+	/// <summary>
+	/// Number of writes replaced by a newer payload before being dequeued.
+	/// Wraps around.
+	/// </summary>
+	const uint8_t GetCoalescedCount() const
+	{
+		return Coalesced;
+	}
+
+private:
+	static constexpr uint8_t GetNextIndex(const uint8_t index)
+	{
+		return (index + 1) % RingSize;
+	}
+};
+#endif
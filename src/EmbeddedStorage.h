@@ -3,20 +3,23 @@
 
 #include <stdint.h>
 #include <WearLevelType.h>
+#include <ErrorCorrectionType.h>
+#include <StorageAddressType.h>
 
 class EmbeddedStorage
 {
 public:
 	/// <summary>
-	/// 1 Extra block for CRC.
-	/// ||Data...|CRC||
+	/// 1 Extra block for CRC, plus optional parity blocks.
+	/// ||Data...|CRC|Parity...||
 	/// </summary>
 	/// <param name="dataSize"></param>
 	/// <param name="wearLevelOption"></param>
+	/// <param name="errorCorrection"></param>
 	/// <returns></returns>
-	static constexpr uint16_t GetStorageSize(const uint16_t dataSize, const NoWearLevel wearLevelOption = NoWearLevel::x1)
+	static constexpr StorageAddress GetStorageSize(const uint16_t dataSize, const NoWearLevel wearLevelOption = NoWearLevel::x1, const ErrorCorrection errorCorrection = ErrorCorrection::None)
 	{
-		return GetSize(dataSize, (uint8_t)NoWearLevel::x1);
+		return GetSize(dataSize + GetParitySize(dataSize, errorCorrection), (uint8_t)NoWearLevel::x1);
 	}
 
 	/// <summary>
@@ -25,10 +28,11 @@ public:
 	/// </summary>
 	/// <param name="dataSize"></param>
 	/// <param name="wearLevelOption"></param>
+	/// <param name="errorCorrection"></param>
 	/// <returns></returns>
-	static constexpr uint16_t GetStorageSize(const uint16_t dataSize, const WearLevelTiny wearLevelOption)
+	static constexpr StorageAddress GetStorageSize(const uint16_t dataSize, const WearLevelTiny wearLevelOption, const ErrorCorrection errorCorrection = ErrorCorrection::None)
 	{
-		return GetSize(dataSize, (uint8_t)wearLevelOption);
+		return GetSize(dataSize + GetParitySize(dataSize, errorCorrection), (uint8_t)wearLevelOption);
 	}
 
 	/// <summary>
@@ -37,10 +41,11 @@ public:
 	/// </summary>
 	/// <param name="dataSize"></param>
 	/// <param name="wearLevelOption"></param>
+	/// <param name="errorCorrection"></param>
 	/// <returns></returns>
-	static constexpr uint16_t GetStorageSize(const uint16_t dataSize, const WearLevelShort wearLevelOption)
+	static constexpr StorageAddress GetStorageSize(const uint16_t dataSize, const WearLevelShort wearLevelOption, const ErrorCorrection errorCorrection = ErrorCorrection::None)
 	{
-		return GetSize(dataSize, (uint8_t)wearLevelOption);
+		return GetSize(dataSize + GetParitySize(dataSize, errorCorrection), (uint8_t)wearLevelOption);
 	}
 
 	/// <summary>
@@ -49,10 +54,11 @@ public:
 	/// </summary>
 	/// <param name="dataSize"></param>
 	/// <param name="wearLevelOption"></param>
+	/// <param name="errorCorrection"></param>
 	/// <returns></returns>
-	static constexpr uint16_t GetStorageSize(const uint16_t dataSize, const WearLevelLong wearLevelOption)
+	static constexpr StorageAddress GetStorageSize(const uint16_t dataSize, const WearLevelLong wearLevelOption, const ErrorCorrection errorCorrection = ErrorCorrection::None)
 	{
-		return GetSize(dataSize, (uint8_t)wearLevelOption);
+		return GetSize(dataSize + GetParitySize(dataSize, errorCorrection), (uint8_t)wearLevelOption);
 	}
 
 	/// <summary>
@@ -61,10 +67,11 @@ public:
 	/// </summary>
 	/// <param name="dataSize"></param>
 	/// <param name="wearLevelOption"></param>
+	/// <param name="errorCorrection"></param>
 	/// <returns></returns>
-	static constexpr uint16_t GetStorageSize(const uint16_t dataSize, const WearLevelLongLong wearLevelOption)
+	static constexpr StorageAddress GetStorageSize(const uint16_t dataSize, const WearLevelLongLong wearLevelOption, const ErrorCorrection errorCorrection = ErrorCorrection::None)
 	{
-		return GetSize(dataSize, (uint8_t)wearLevelOption);
+		return GetSize(dataSize + GetParitySize(dataSize, errorCorrection), (uint8_t)wearLevelOption);
 	}
 
 private:
@@ -77,17 +84,49 @@ private:
 	/// <param name="dataSize"></param>
 	/// <param name="wearLevelOption"></param>
 	/// <returns></returns>
-	static constexpr uint16_t GetSize(const uint16_t dataSize, const uint8_t wearLevelOption)
+	static constexpr uint32_t GetSize(const uint32_t dataSize, const uint8_t wearLevelOption)
 	{
 		return ((wearLevelOption > (uint8_t)NoWearLevel::x1) * (GetWearLevelCounterSize(wearLevelOption))) +
 			((1 + dataSize) * wearLevelOption);
 	}
 
-#if defined(WEAR_LEVEL_DEBUG)
 public:
-#else
-private:
-#endif
+	/// <summary>
+	/// Full width storage size, for compile-time overflow checks.
+	/// </summary>
+	/// <param name="dataSize"></param>
+	/// <param name="wearLevelOption"></param>
+	/// <param name="errorCorrection"></param>
+	/// <returns></returns>
+	template<typename WearLevelType>
+	static constexpr uint32_t GetStorageSpan(const uint16_t dataSize, const WearLevelType wearLevelOption, const ErrorCorrection errorCorrection = ErrorCorrection::None)
+	{
+		return GetSize((uint32_t)dataSize + GetParitySize(dataSize, errorCorrection), (uint8_t)wearLevelOption);
+	}
+
+	/// <summary>
+	/// True if size bytes starting at address are addressable with StorageAddress.
+	/// </summary>
+	/// <param name="address"></param>
+	/// <param name="size"></param>
+	/// <returns></returns>
+	static constexpr bool Fits(const uint32_t address, const uint32_t size)
+	{
+		return (size <= (uint32_t)(StorageAddress)~(StorageAddress)0)
+			&& (((uint64_t)address + size) <= ((uint64_t)(StorageAddress)~(StorageAddress)0 + 1));
+	}
+
+	/// <summary>
+	/// Error correction parity size, for Data and CRC.
+	/// </summary>
+	/// <param name="dataSize"></param>
+	/// <param name="errorCorrection"></param>
+	/// <returns></returns>
+	static constexpr uint16_t GetParitySize(const uint16_t dataSize, const ErrorCorrection errorCorrection)
+	{
+		return (errorCorrection == ErrorCorrection::Secded) * ((dataSize + 1 + 7) / 8);
+	}
+
 	static constexpr uint16_t GetWearLevelCounterSize(const uint8_t wearLevelOption)
 	{
 		return ((wearLevelOption <= (uint8_t)WearLevelTiny::x9) * sizeof(uint8_t))
@@ -0,0 +1,170 @@
+#ifndef _EMBEDDED_CODEC_
+#define _EMBEDDED_CODEC_
+
+#include "EmbeddedEEPROM.h"
+
+/// <summary>
+/// Delta + Run-Length codec, streamed straight into/from EEPROM.
+/// Each byte is stored as the difference to the previous one,
+///  so zero runs and slowly varying values collapse into repeated deltas.
+/// Token format:
+///  0b0nnnnnnn - Literal, n+1 delta bytes follow.
+///  0b1nnnnnnn - Repeat, the next delta byte is repeated n+1 times.
+/// Unchanged bytes are never re-programmed, as EEPROM writes are updates.
+/// </summary>
+class DeltaRleCodec
+{
+private:
+	static constexpr uint8_t TokenMaxCount = 128;
+	static constexpr uint8_t RepeatFlag = 0x80;
+	static constexpr uint8_t RepeatMinCount = 3;
+
+public:
+	/// <summary>
+	/// Worst case is all literals: 1 token byte for every 128 data bytes.
+	/// </summary>
+	/// <param name="dataSize"></param>
+	/// <returns></returns>
+	static constexpr uint16_t GetMaxEncodedSize(const uint16_t dataSize)
+	{
+		return dataSize + ((dataSize + TokenMaxCount - 1) / TokenMaxCount);
+	}
+
+	/// <summary>
+	/// Length prefix and worst case encoded size.
+	/// ||Length|Encoded...||
+	/// </summary>
+	/// <param name="dataSize"></param>
+	/// <returns></returns>
+	static constexpr uint16_t GetSlotSize(const uint16_t dataSize)
+	{
+		return sizeof(uint16_t) + GetMaxEncodedSize(dataSize);
+	}
+
+	/// <summary>
+	/// Encodes source into EEPROM, starting at address.
+	/// </summary>
+	/// <param name="address">EEPROM target address.</param>
+	/// <param name="source">Source array.</param>
+	/// <param name="size">Source size in bytes.</param>
+	/// <returns>Encoded length in bytes.</returns>
+	static const uint16_t Encode(const StorageAddress address, const uint8_t* source, const uint16_t size)
+	{
+		uint16_t length = 0;
+		uint16_t index = 0;
+
+		while (index < size)
+		{
+			const uint8_t repeats = GetRepeatCount(source, index, size);
+
+			if (repeats >= RepeatMinCount)
+			{
+				EmbeddedEEPROM::WriteBlock(address + length++, RepeatFlag | (repeats - 1));
+				EmbeddedEEPROM::WriteBlock(address + length++, GetDelta(source, index));
+				index += repeats;
+			}
+			else
+			{
+				// Literal run, up to the next worthwhile repeat.
+				uint8_t literals = 1;
+				while (((index + literals) < size)
+					&& (literals < TokenMaxCount)
+					&& (GetRepeatCount(source, index + literals, size) < RepeatMinCount))
+				{
+					literals++;
+				}
+
+				EmbeddedEEPROM::WriteBlock(address + length++, literals - 1);
+				for (uint8_t i = 0; i < literals; i++)
+				{
+					EmbeddedEEPROM::WriteBlock(address + length++, GetDelta(source, index + i));
+				}
+				index += literals;
+			}
+		}
+
+		return length;
+	}
+
+	/// <summary>
+	/// Decodes length bytes from EEPROM at address, into target.
+	/// </summary>
+	/// <param name="address">EEPROM source address.</param>
+	/// <param name="length">Encoded length in bytes.</param>
+	/// <param name="target">Target array.</param>
+	/// <param name="size">Target size in bytes.</param>
+	/// <returns>True if the encoded stream is well formed and fills target exactly.</returns>
+	static const bool Decode(const StorageAddress address, const uint16_t length, uint8_t* target, const uint16_t size)
+	{
+		uint16_t position = 0;
+		uint16_t index = 0;
+		uint8_t value = 0;
+
+		while (position < length)
+		{
+			const uint8_t token = EmbeddedEEPROM::ReadBlock(address + position++);
+			const uint8_t count = (token & ~RepeatFlag) + 1;
+
+			if (token & RepeatFlag)
+			{
+				if (position >= length
+					|| (index + count) > size)
+				{
+					return false;
+				}
+
+				const uint8_t delta = EmbeddedEEPROM::ReadBlock(address + position++);
+				for (uint8_t i = 0; i < count; i++)
+				{
+					value += delta;
+					target[index++] = value;
+				}
+			}
+			else
+			{
+				if ((position + count) > length
+					|| (index + count) > size)
+				{
+					return false;
+				}
+
+				for (uint8_t i = 0; i < count; i++)
+				{
+					value += EmbeddedEEPROM::ReadBlock(address + position++);
+					target[index++] = value;
+				}
+			}
+		}
+
+		return index == size;
+	}
+
+private:
+	static const uint8_t GetDelta(const uint8_t* source, const uint16_t index)
+	{
+		if (index > 0)
+		{
+			return source[index] - source[index - 1];
+		}
+		else
+		{
+			return source[index];
+		}
+	}
+
+	static const uint8_t GetRepeatCount(const uint8_t* source, const uint16_t index, const uint16_t size)
+	{
+		const uint8_t delta = GetDelta(source, index);
+		uint8_t count = 1;
+
+		while (((index + count) < size)
+			&& (count < TokenMaxCount)
+			&& (GetDelta(source, index + count) == delta))
+		{
+			count++;
+		}
+
+		return count;
+	}
+};
+#endif
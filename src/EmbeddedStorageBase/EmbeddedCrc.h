@@ -7,31 +7,76 @@
 #pragma Depends on https://github.com/RobTillaart/CRC
 #else
 /// <summary>
-/// Template based abstraction for 8 bit CRC calculation.
+/// Run-time keyed 8 bit CRC calculation, shared by every EmbeddedCrc<Key>.
 /// Depends on https://github.com/RobTillaart/CRC .
 /// </summary>
-/// <param name="Key">Crypto MAC key.</param>
-template<const uint32_t Key = 0>
-class EmbeddedCrc
+class KeyedCrc
 {
 private:
 	CRC8 Crc8{};
 
 public:
-	EmbeddedCrc() {}
+	KeyedCrc() {}
 
-	const uint8_t GetCrc(const uint8_t* data, const uint16_t length, const uint8_t salt = 0)
+	const uint8_t GetCrc(const uint8_t* data, const uint16_t length, const uint32_t key, const uint8_t salt = 0)
+	{
+		Start();
+		Add(data, length);
+
+		return Finish(key, salt);
+	}
+
+	/// <summary>
+	/// Incremental CRC calculation, for data that isn't held in a single array.
+	/// Start(), Add()... and Finish() yields the same result as GetCrc().
+	/// </summary>
+	void Start()
 	{
 		Crc8.reset();
+	}
+
+	void Add(const uint8_t value)
+	{
+		Crc8.add(value);
+	}
+
+	void Add(const uint8_t* data, const uint16_t length)
+	{
 		Crc8.add(data, (uint16_t)length);
-		Crc8.add((uint8_t)((Key >> 24) & UINT8_MAX));
-		Crc8.add((uint8_t)((Key >> 16) & UINT8_MAX));
-		Crc8.add((uint8_t)((Key >> 8) & UINT8_MAX));
-		Crc8.add((uint8_t)(Key & UINT8_MAX));
+	}
+
+	const uint8_t Finish(const uint32_t key, const uint8_t salt = 0)
+	{
+		Crc8.add((uint8_t)((key >> 24) & UINT8_MAX));
+		Crc8.add((uint8_t)((key >> 16) & UINT8_MAX));
+		Crc8.add((uint8_t)((key >> 8) & UINT8_MAX));
+		Crc8.add((uint8_t)(key & UINT8_MAX));
 		Crc8.add(salt);
 
 		return Crc8.calc();
 	}
 };
+
+/// <summary>
+/// Template based abstraction for 8 bit CRC calculation.
+/// Depends on https://github.com/RobTillaart/CRC .
+/// </summary>
+/// <param name="Key">Crypto MAC key.</param>
+template<const uint32_t Key = 0>
+class EmbeddedCrc : public KeyedCrc
+{
+public:
+	EmbeddedCrc() : KeyedCrc() {}
+
+	const uint8_t GetCrc(const uint8_t* data, const uint16_t length, const uint8_t salt = 0)
+	{
+		return KeyedCrc::GetCrc(data, length, Key, salt);
+	}
+
+	const uint8_t Finish(const uint8_t salt = 0)
+	{
+		return KeyedCrc::Finish(Key, salt);
+	}
+};
 #endif
 #endif
\ No newline at end of file
@@ -0,0 +1,112 @@
+#ifndef _EMBEDDED_DEVICE_PROFILE_
+#define _EMBEDDED_DEVICE_PROFILE_
+
+#include <stdint.h>
+
+/// <summary>
+/// ATmega328P internal EEPROM.
+/// Per byte operation times, in microseconds, from the datasheet's programming times.
+/// Endurance in erase/write cycles, per erase block of EraseGranularity bytes.
+/// </summary>
+struct DeviceProfileATmega328P
+{
+	static constexpr uint32_t Capacity = 1024;
+	static constexpr uint32_t EnduranceCycles = 100000;
+	static constexpr uint16_t EraseGranularity = 1;
+
+	static constexpr uint16_t ReadMicros = 1;
+	static constexpr uint16_t EraseWriteMicros = 3400;
+	static constexpr uint16_t EraseMicros = 1800;
+	static constexpr uint16_t WriteMicros = 1800;
+};
+
+/// <summary>
+/// ATtiny85 internal EEPROM.
+/// Same programming times as the ATmega328P, half the capacity.
+/// </summary>
+struct DeviceProfileATtiny85
+{
+	static constexpr uint32_t Capacity = 512;
+	static constexpr uint32_t EnduranceCycles = 100000;
+	static constexpr uint16_t EraseGranularity = 1;
+
+	static constexpr uint16_t ReadMicros = 1;
+	static constexpr uint16_t EraseWriteMicros = 3400;
+	static constexpr uint16_t EraseMicros = 1800;
+	static constexpr uint16_t WriteMicros = 1800;
+};
+
+/// <summary>
+/// 24LC256 external I2C EEPROM, at 400 kHz.
+/// Random byte read is 5 bus bytes.
+/// There is no erase-only or write-only mode, every write is a full write cycle.
+/// Any write counts as a cycle for its whole 64 byte page.
+/// </summary>
+struct DeviceProfile24LC256
+{
+	static constexpr uint32_t Capacity = 32768;
+	static constexpr uint32_t EnduranceCycles = 1000000;
+	static constexpr uint16_t EraseGranularity = 64;
+
+	static constexpr uint16_t ReadMicros = 115;
+	static constexpr uint16_t EraseWriteMicros = 5000;
+	static constexpr uint16_t EraseMicros = 5000;
+	static constexpr uint16_t WriteMicros = 5000;
+};
+
+/// <summary>
+/// 24LC1025 external I2C EEPROM, at 400 kHz.
+/// Same timing as the 24LC256, 128 KB requires EEPROM_ADDRESS_32.
+/// </summary>
+struct DeviceProfile24LC1025
+{
+	static constexpr uint32_t Capacity = 131072;
+	static constexpr uint32_t EnduranceCycles = 1000000;
+	static constexpr uint16_t EraseGranularity = 128;
+
+	static constexpr uint16_t ReadMicros = 115;
+	static constexpr uint16_t EraseWriteMicros = 5000;
+	static constexpr uint16_t EraseMicros = 5000;
+	static constexpr uint16_t WriteMicros = 5000;
+};
+
+/// <summary>
+/// FM24V10 I2C FRAM, at 400 kHz.
+/// Writes have no programming delay, only bus time.
+/// Endurance is 10^14 cycles, saturated to UINT32_MAX.
+/// 128 KB requires EEPROM_ADDRESS_32.
+/// </summary>
+struct DeviceProfileFM24V10
+{
+	static constexpr uint32_t Capacity = 131072;
+	static constexpr uint32_t EnduranceCycles = UINT32_MAX;
+	static constexpr uint16_t EraseGranularity = 1;
+
+	static constexpr uint16_t ReadMicros = 115;
+	static constexpr uint16_t EraseWriteMicros = 90;
+	static constexpr uint16_t EraseMicros = 90;
+	static constexpr uint16_t WriteMicros = 90;
+};
+
+/// <summary>
+/// Simulated clock and operation counts of the in-memory EEPROM mock.
+/// </summary>
+struct EmbeddedEEPROMClock
+{
+	uint32_t ElapsedMicros;
+	uint32_t Reads;
+	uint32_t EraseWrites;
+	uint32_t Erases;
+	uint32_t Writes;
+
+	/// <summary>
+	/// WriteBlock() calls skipped because the value was already stored.
+	/// </summary>
+	uint32_t Skipped;
+
+	/// <summary>
+	/// Accesses beyond the device's capacity, refused by the mock.
+	/// </summary>
+	uint32_t Refused;
+};
+#endif
@@ -1,17 +1,38 @@
 #ifndef _EMBEDDED_EEPROM_
 #define _EMBEDDED_EEPROM_
 
-#if defined(ARDUINO_ARCH_AVR) && (defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328p__) || defined(__AVR_atmega328p__) || defined(__AVR_ATtiny85__))
+#if (defined(ARDUINO_ARCH_AVR) && (defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328p__) || defined(__AVR_atmega328p__) || defined(__AVR_ATtiny85__))) || defined(EEPROM_MOCK_IN_MEMORY)
 #include <stdint.h>
 #include <EEPROM.h>
+#include "EmbeddedDeviceProfile.h"
+#include <StorageAddressType.h>
+
+// Records wearing operations into a RAM ring buffer, for export with EmbeddedTrace::Export().
+// Disabled by default, costs 7 bytes of RAM per EEPROM_TRACE_SIZE entry (9 with EEPROM_ADDRESS_32).
+// #define EEPROM_TRACE
+#if defined(EEPROM_TRACE)
+#include "EmbeddedTrace.h"
+#endif
 
 // Allocates a memory array of the same size as the EEPROM.
 // For testing purposes only.
+// Further devices can be instanced and selected per thread, see MockEepromDevice.
 //#define EEPROM_MOCK_IN_MEMORY
 
+// Device timing profile for the mock's simulated clock.
+// Defaults to the target MCU's internal EEPROM.
+// #define EEPROM_MOCK_PROFILE DeviceProfile24LC256
+#if !defined(EEPROM_MOCK_PROFILE)
+#if defined(__AVR_ATtiny85__)
+#define EEPROM_MOCK_PROFILE DeviceProfileATtiny85
+#else
+#define EEPROM_MOCK_PROFILE DeviceProfileATmega328P
+#endif
+#endif
+
 
-// Checks if the write address is within Unit space, at run time.
-// Disabled by default, for performance.
+// Checks if the address is within the EEPROM, at run time. Out of range accesses are refused.
+// Disabled by default, for performance. The in-memory mock always checks against the selected device.
 // Enable for validation, and supply optional Macro for error handling. 
 // #define EEPROM_BOUNDS_CHECK
 
@@ -22,7 +43,8 @@
 #endif
 
 #if defined(EEPROM_MOCK_IN_MEMORY)
-static uint8_t InMemory[E2END + 1]{};
+#include "EmbeddedMockDevice.h"
+static_assert((EEPROM_MOCK_PROFILE::Capacity - 1) <= (StorageAddress)~(StorageAddress)0, "EEPROM_MOCK_PROFILE capacity requires EEPROM_ADDRESS_32.");
 #endif
 
 /// <summary>
@@ -32,38 +54,134 @@ static uint8_t InMemory[E2END + 1]{};
 class EmbeddedEEPROM
 {
 public:
-	static constexpr uint16_t Size() { return E2END + 1; };
+	/// <summary>
+	/// Compile-time EEPROM size, for layouts.
+	/// With EEPROM_MOCK_IN_MEMORY, the default device's, see MockSize() for the selected device.
+	/// </summary>
+#if defined(EEPROM_MOCK_IN_MEMORY)
+	static constexpr uint32_t Size() { return EEPROM_MOCK_PROFILE::Capacity; };
+#else
+	static constexpr uint32_t Size() { return (uint32_t)E2END + 1; };
+#endif
 
 #if defined(EEPROM_MOCK_IN_MEMORY)
+	/// <summary>
+	/// The calling thread's selected device, or the default EEPROM_MOCK_PROFILE device.
+	/// </summary>
+	static MockEepromDevice& MockDevice()
+	{
+		static TemplateMockEepromDevice<EEPROM_MOCK_PROFILE> defaultDevice{};
+
+		MockEepromDevice* selected = MockEepromDevice::GetSelected();
+
+		return (selected != nullptr) ? *selected : defaultDevice;
+	}
+
+	/// <summary>
+	/// Run-time size of the selected device.
+	/// </summary>
+	static const uint32_t MockSize()
+	{
+		return MockDevice().Capacity;
+	}
+
+	/// <summary>
+	/// Simulated clock of the current device, accumulated with its operation times.
+	/// Reset before a call and read after, for the call's latency.
+	/// </summary>
+	static EmbeddedEEPROMClock& MockClock()
+	{
+		return MockDevice().Clock;
+	}
+
+	static void ResetMockClock()
+	{
+		MockClock() = EmbeddedEEPROMClock{};
+	}
+
 	static void EraseEEPROM()
 	{
-		memset(InMemory, UINT8_MAX, sizeof(InMemory));
+		MockDevice().Erase();
 	}
 
-	static void WriteBlock(const uint16_t offset, const uint8_t block)
+	/// <summary>
+	/// Same as EEPROM.update(): read and compare, erase and write only if different.
+	/// </summary>
+	static void WriteBlock(const StorageAddress offset, const uint8_t block)
 	{
-#if defined(EEPROM_BOUNDS_CHECK)
-		CheckBounds(offset);
+		MockEepromDevice& device = MockDevice();
+		if (!CheckMockBounds(device, offset))
+		{
+			return;
+		}
+
+		device.Clock.Reads++;
+		device.Clock.ElapsedMicros += device.ReadMicros;
+
+		if (device.Memory[offset] == block)
+		{
+			device.Clock.Skipped++;
+		}
+		else
+		{
+			device.Clock.EraseWrites++;
+			device.Clock.ElapsedMicros += device.EraseWriteMicros;
+			device.Memory[offset] = block;
+#if defined(EEPROM_TRACE)
+			EmbeddedTrace::Record(TraceOperation::EraseWrite, offset);
 #endif
-		InMemory[offset] = block;
+		}
 	}
 
-	static const uint8_t ReadBlock(const uint16_t offset)
+	/// <summary>
+	/// Out of range reads return an erased byte.
+	/// </summary>
+	static const uint8_t ReadBlock(const StorageAddress offset)
 	{
-#if defined(EEPROM_BOUNDS_CHECK)
-		CheckBounds(offset);
-#endif
-		return InMemory[offset];
+		MockEepromDevice& device = MockDevice();
+		if (!CheckMockBounds(device, offset))
+		{
+			return UINT8_MAX;
+		}
+
+		device.Clock.Reads++;
+		device.Clock.ElapsedMicros += device.ReadMicros;
+
+		return device.Memory[offset];
 	}
 
-	static void ProgramZeroBitsToZero(const uint16_t offset, const uint8_t byteWithZeros)
+	static void ProgramZeroBitsToZero(const StorageAddress offset, const uint8_t byteWithZeros)
 	{
-		InMemory[offset] &= byteWithZeros;
+		MockEepromDevice& device = MockDevice();
+		if (!CheckMockBounds(device, offset))
+		{
+			return;
+		}
+
+		device.Clock.Writes++;
+		device.Clock.ElapsedMicros += device.WriteMicros;
+#if defined(EEPROM_TRACE)
+		EmbeddedTrace::Record(TraceOperation::Write, offset);
+#endif
+
+		device.Memory[offset] &= byteWithZeros;
 	}
 
-	static void ClearByteToOnes(const uint16_t offset)
+	static void ClearByteToOnes(const StorageAddress offset)
 	{
-		InMemory[offset] = UINT8_MAX;
+		MockEepromDevice& device = MockDevice();
+		if (!CheckMockBounds(device, offset))
+		{
+			return;
+		}
+
+		device.Clock.Erases++;
+		device.Clock.ElapsedMicros += device.EraseMicros;
+#if defined(EEPROM_TRACE)
+		EmbeddedTrace::Record(TraceOperation::Erase, offset);
+#endif
+
+		device.Memory[offset] = UINT8_MAX;
 	}
 #else
 		/// <summary>
@@ -71,24 +189,38 @@ public:
 		/// </summary>
 		static void EraseEEPROM()
 	{
-		for (uint16_t i = 0; i < Size(); i++)
+		for (uint32_t i = 0; i < Size(); i++)
 		{
 			EEPROM.update(i, UINT8_MAX);
 		}
 	}
 
-	static void WriteBlock(const uint16_t offset, const uint8_t block)
+	static void WriteBlock(const StorageAddress offset, const uint8_t block)
 	{
 #if defined(EEPROM_BOUNDS_CHECK)
-		CheckBounds(offset);
+		if (!CheckBounds(offset))
+		{
+			return;
+		}
 #endif
+#if defined(EEPROM_TRACE)
+		if (EEPROM[offset] != block)
+		{
+			EmbeddedTrace::Record(TraceOperation::EraseWrite, offset);
+			EEPROM.write(offset, block);
+		}
+#else
 		EEPROM.update(offset, block);
+#endif
 	}
 
-	static const uint8_t ReadBlock(const uint16_t offset)
+	static const uint8_t ReadBlock(const StorageAddress offset)
 	{
 #if defined(EEPROM_BOUNDS_CHECK)
-		CheckBounds(offset);
+		if (!CheckBounds(offset))
+		{
+			return UINT8_MAX;
+		}
 #endif
 		return EEPROM[offset];
 	}
@@ -101,8 +233,17 @@ public:
 	/// <typeparam name="Address"></typeparam>
 	/// <param name="offset"></param>
 	/// <param name="byteWithZeros"></param>
-	static void ProgramZeroBitsToZero(const uint16_t offset, const uint8_t byteWithZeros)
+	static void ProgramZeroBitsToZero(const StorageAddress offset, const uint8_t byteWithZeros)
 	{
+#if defined(EEPROM_BOUNDS_CHECK)
+		if (!CheckBounds(offset))
+		{
+			return;
+		}
+#endif
+#if defined(EEPROM_TRACE)
+		EmbeddedTrace::Record(TraceOperation::Write, offset);
+#endif
 		//// Wait for completion of any pending operations.
 		//while (EECR & (1 << EEPE));
 
@@ -137,8 +278,17 @@ public:
 		while (EECR & (1 << EEPE));
 	}
 
-	static void ClearByteToOnes(const uint16_t offset)
+	static void ClearByteToOnes(const StorageAddress offset)
 	{
+#if defined(EEPROM_BOUNDS_CHECK)
+		if (!CheckBounds(offset))
+		{
+			return;
+		}
+#endif
+#if defined(EEPROM_TRACE)
+		EmbeddedTrace::Record(TraceOperation::Erase, offset);
+#endif
 		// Wait for completion of any pending operations.
 		while (EECR & (1 << EEPE));
 
@@ -173,14 +323,67 @@ public:
 	}
 #endif
 
+public:
+	/// <summary>
+	/// Cost of storing block over the current value.
+	/// </summary>
+	/// <returns>0 if unchanged, 1 if only zeros are programmed (write-only), 2 if an erase is needed.</returns>
+	static constexpr uint8_t GetWriteCost(const uint8_t current, const uint8_t block)
+	{
+		return (current == block) ? 0 : (((uint8_t)(block & ~current) == 0) ? 1 : 2);
+	}
+
+	/// <summary>
+	/// Writes block with the cheapest mode:
+	///  skipped if unchanged, write-only if only zeros are programmed, erase and write otherwise.
+	/// </summary>
+	/// <returns>Write cost, as GetWriteCost().</returns>
+	static const uint8_t ProgramBlock(const StorageAddress offset, const uint8_t block)
+	{
+		const uint8_t cost = GetWriteCost(ReadBlock(offset), block);
+
+		if (cost == 1)
+		{
+			ProgramZeroBitsToZero(offset, block);
+		}
+		else if (cost == 2)
+		{
+			WriteBlock(offset, block);
+		}
+
+		return cost;
+	}
+
 private:
-#if defined(EEPROM_BOUNDS_CHECK)
-	static void CheckBounds(int offset)
+#if defined(EEPROM_MOCK_IN_MEMORY)
+	/// <summary>
+	/// Always on for the mock, against the selected device's capacity.
+	/// </summary>
+	/// <returns>False if the access is refused.</returns>
+	static const bool CheckMockBounds(MockEepromDevice& device, const StorageAddress offset)
+	{
+		if ((uint32_t)offset >= device.Capacity)
+		{
+			device.Clock.Refused++;
+			EEPROM_ON_ERROR(offset);
+
+			return false;
+		}
+
+		return true;
+	}
+#elif defined(EEPROM_BOUNDS_CHECK)
+	/// <returns>False if the access is refused.</returns>
+	static const bool CheckBounds(const StorageAddress offset)
 	{
 		if ((uint32_t)offset >= Size())
 		{
 			EEPROM_ON_ERROR(offset);
+
+			return false;
 		}
+
+		return true;
 	}
 #endif
 };
@@ -0,0 +1,233 @@
+#ifndef _EMBEDDED_ECC_
+#define _EMBEDDED_ECC_
+
+#include "EmbeddedEEPROM.h"
+#include <EmbeddedStorage.h>
+
+/// <summary>
+/// Hamming SECDED (72,64) error correction.
+/// 1 parity byte for every 8 byte block: 7 Hamming bits and 1 overall parity bit.
+/// Slot payload is Data and CRC, parity follows.
+/// ||Data...|CRC|Parity...||
+/// </summary>
+class EmbeddedEcc
+{
+public:
+	static constexpr uint8_t BlockSize = 8;
+
+	enum class EccResult : uint8_t
+	{
+		Clean,
+		Corrected,
+		Uncorrectable
+	};
+
+public:
+	/// <summary>
+	/// Parity byte for a block of up to 8 bytes.
+	/// </summary>
+	/// <param name="block"></param>
+	/// <param name="length"></param>
+	/// <returns>7 bit Hamming syndrome | overall parity bit.</returns>
+	static const uint8_t GetParity(const uint8_t* block, const uint8_t length)
+	{
+		uint8_t syndrome = 0;
+		uint8_t parity = 0;
+		uint8_t position = 2;
+
+		for (uint8_t i = 0; i < length; i++)
+		{
+			for (uint8_t bit = 0; bit < 8; bit++)
+			{
+				position = GetNextPosition(position);
+				if ((block[i] >> bit) & 1)
+				{
+					syndrome ^= position;
+					parity ^= 1;
+				}
+			}
+		}
+
+		return syndrome | ((parity ^ GetBitParity(syndrome)) << 7);
+	}
+
+	/// <summary>
+	/// Corrects a single bit error in block, in place.
+	/// </summary>
+	/// <param name="block"></param>
+	/// <param name="length"></param>
+	/// <param name="storedParity"></param>
+	/// <returns>Clean, Corrected (data or parity bit) or Uncorrectable (double bit error).</returns>
+	static const EccResult Correct(uint8_t* block, const uint8_t length, const uint8_t storedParity)
+	{
+		const uint8_t difference = GetParity(block, length) ^ storedParity;
+		const uint8_t syndrome = difference & INT8_MAX;
+
+		if (difference == 0)
+		{
+			return EccResult::Clean;
+		}
+		else if (!GetBitParity(difference))
+		{
+			// Even number of flipped bits.
+			return EccResult::Uncorrectable;
+		}
+		else if ((syndrome & (syndrome - 1)) == 0)
+		{
+			// Flipped bit is in the parity byte itself.
+			return EccResult::Corrected;
+		}
+
+		uint8_t position = 2;
+		for (uint8_t i = 0; i < length; i++)
+		{
+			for (uint8_t bit = 0; bit < 8; bit++)
+			{
+				position = GetNextPosition(position);
+				if (position == syndrome)
+				{
+					block[i] ^= (1 << bit);
+					return EccResult::Corrected;
+				}
+			}
+		}
+
+		return EccResult::Uncorrectable;
+	}
+
+	/// <summary>
+	/// Writes the parity blocks for Data and CRC.
+	/// </summary>
+	/// <param name="slotAddress">Slot start address.</param>
+	/// <param name="source">Data array.</param>
+	/// <param name="dataSize">Data size in bytes.</param>
+	/// <param name="crc">Data CRC.</param>
+	static void WriteParity(const StorageAddress slotAddress, const uint8_t* source, const uint16_t dataSize, const uint8_t crc)
+	{
+		uint8_t block[BlockSize];
+		const uint16_t payloadSize = dataSize + 1;
+
+		for (uint16_t offset = 0; offset < payloadSize; offset += BlockSize)
+		{
+			const uint8_t length = GetBlock(block, offset, source, dataSize, crc);
+			EmbeddedEEPROM::WriteBlock(slotAddress + payloadSize + (offset / BlockSize), GetParity(block, length));
+		}
+	}
+
+	/// <summary>
+	/// Corrects single bit errors in target and crc, block by block, in RAM only.
+	/// Nothing is written: the caller checks the CRC first, then repairs with RepairSlot().
+	/// </summary>
+	/// <param name="slotAddress">Slot start address.</param>
+	/// <param name="target">Data array, as read.</param>
+	/// <param name="dataSize">Data size in bytes.</param>
+	/// <param name="crc">Data CRC, as read.</param>
+	/// <param name="corrections">Number of corrected blocks.</param>
+	/// <returns>False if any block is uncorrectable.</returns>
+	static const bool CorrectSlot(const StorageAddress slotAddress, uint8_t* target, const uint16_t dataSize, uint8_t& crc, uint8_t& corrections)
+	{
+		uint8_t block[BlockSize];
+		const uint16_t payloadSize = dataSize + 1;
+
+		for (uint16_t offset = 0; offset < payloadSize; offset += BlockSize)
+		{
+			const uint8_t length = GetBlock(block, offset, target, dataSize, crc);
+
+			switch (Correct(block, length, EmbeddedEEPROM::ReadBlock(slotAddress + payloadSize + (offset / BlockSize))))
+			{
+			case EccResult::Clean:
+				break;
+			case EccResult::Corrected:
+				corrections++;
+				SetBlock(block, length, offset, target, dataSize, crc);
+				break;
+			case EccResult::Uncorrectable:
+			default:
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Writes back a corrected slot, once its CRC matches.
+	/// Only the corrected byte and parity bytes differ, the others are skipped by WriteBlock.
+	/// </summary>
+	/// <param name="slotAddress">Slot start address.</param>
+	/// <param name="source">Corrected data array.</param>
+	/// <param name="dataSize">Data size in bytes.</param>
+	/// <param name="crc">Corrected data CRC.</param>
+	static void RepairSlot(const StorageAddress slotAddress, const uint8_t* source, const uint16_t dataSize, const uint8_t crc)
+	{
+		for (uint16_t i = 0; i < dataSize; i++)
+		{
+			EmbeddedEEPROM::WriteBlock(slotAddress + i, source[i]);
+		}
+		EmbeddedEEPROM::WriteBlock(slotAddress + dataSize, crc);
+
+		WriteParity(slotAddress, source, dataSize, crc);
+	}
+
+private:
+	static const uint8_t GetBlock(uint8_t* block, const uint16_t offset, const uint8_t* data, const uint16_t dataSize, const uint8_t crc)
+	{
+		const uint16_t payloadSize = dataSize + 1;
+		uint8_t length = BlockSize;
+		if ((payloadSize - offset) < BlockSize)
+		{
+			length = payloadSize - offset;
+		}
+
+		for (uint8_t i = 0; i < length; i++)
+		{
+			if ((offset + i) < dataSize)
+			{
+				block[i] = data[offset + i];
+			}
+			else
+			{
+				block[i] = crc;
+			}
+		}
+
+		return length;
+	}
+
+	static void SetBlock(const uint8_t* block, const uint8_t length, const uint16_t offset,
+		uint8_t* data, const uint16_t dataSize, uint8_t& crc)
+	{
+		for (uint8_t i = 0; i < length; i++)
+		{
+			if ((offset + i) < dataSize)
+			{
+				data[offset + i] = block[i];
+			}
+			else
+			{
+				crc = block[i];
+			}
+		}
+	}
+
+	static const uint8_t GetNextPosition(uint8_t position)
+	{
+		// Skip power of 2 positions, reserved for Hamming bits.
+		do
+		{
+			position++;
+		} while ((position & (position - 1)) == 0);
+
+		return position;
+	}
+
+	static const uint8_t GetBitParity(uint8_t value)
+	{
+		value ^= value >> 4;
+		value ^= value >> 2;
+		value ^= value >> 1;
+
+		return value & 1;
+	}
+};
+#endif
@@ -0,0 +1,34 @@
+#ifndef _EMBEDDED_HASH_
+#define _EMBEDDED_HASH_
+
+#include <stdint.h>
+
+/// <summary>
+/// Compile-time 32 bit FNV-1a hash.
+/// Used to fingerprint layouts and schemas.
+/// </summary>
+class EmbeddedHash
+{
+public:
+	static constexpr uint32_t Seed = 2166136261UL;
+
+private:
+	static constexpr uint32_t Prime = 16777619UL;
+
+public:
+	static constexpr uint32_t Add(const uint32_t hash, const uint8_t value)
+	{
+		return (uint32_t)((hash ^ value) * Prime);
+	}
+
+	static constexpr uint32_t Add16(const uint32_t hash, const uint16_t value)
+	{
+		return Add(Add(hash, value & UINT8_MAX), value >> 8);
+	}
+
+	static constexpr uint32_t Add32(const uint32_t hash, const uint32_t value)
+	{
+		return Add16(Add16(hash, value & UINT16_MAX), value >> 16);
+	}
+};
+#endif
@@ -0,0 +1,132 @@
+#ifndef _EMBEDDED_I2C_DEVICE_
+#define _EMBEDDED_I2C_DEVICE_
+
+#include <stdint.h>
+#include <Wire.h>
+#include <StorageAddressType.h>
+
+/// <summary>
+/// External I2C EEPROM driver for StripedWriteScheduler, i.e. 24LC256.
+/// 2 byte memory addressing, up to 64 KB per device address.
+/// With EEPROM_ADDRESS_32, address bit 16 selects the 24LC1025's upper block (B0 bit of the control byte),
+///  up to 128 KB per chip. Addresses beyond 128 KB are refused: writes are dropped, reads return 0xFF.
+/// Writes return as soon as the chip has the bytes, the page write cycle runs inside the chip.
+/// The chip doesn't acknowledge its address during a write cycle, IsBusy() polls for that ACK.
+/// </summary>
+class I2CEepromDevice
+{
+private:
+	// Wire transmit buffer, less the 2 memory address bytes.
+#if defined(BUFFER_LENGTH)
+	static constexpr uint8_t WireDataSize = BUFFER_LENGTH - 2;
+#else
+	static constexpr uint8_t WireDataSize = 30;
+#endif
+
+private:
+	const uint8_t DeviceAddress;
+	const uint8_t PageSize;
+
+public:
+	/// <param name="deviceAddress">7 bit I2C address, 0x50 to 0x57 with the A2..A0 pins.
+	///  0x50 to 0x53 for the 24LC1025, its A2 pin must be tied high and its B0 bit is the block select.</param>
+	/// <param name="pageSize">Chip page size, a power of 2, i.e. 64 for the 24LC256, 128 for the 24LC1025.</param>
+	I2CEepromDevice(const uint8_t deviceAddress = 0x50, const uint8_t pageSize = 64)
+		: DeviceAddress(deviceAddress)
+		, PageSize(pageSize)
+	{}
+
+	void Begin()
+	{
+		Wire.begin();
+	}
+
+	/// <summary>
+	/// The chip acknowledges neither block's control byte during a write cycle,
+	///  so polling the base address covers both 24LC1025 blocks.
+	/// </summary>
+	const bool IsBusy()
+	{
+		Wire.beginTransmission(DeviceAddress);
+
+		return Wire.endTransmission() != 0;
+	}
+
+	/// <summary>
+	/// Bytes per page write, the chip's page size halved until it fits the Wire buffer.
+	/// Still aligned to the chip's pages, so a page write never wraps inside the chip.
+	/// </summary>
+	const uint8_t GetPageSize() const
+	{
+		uint8_t size = PageSize;
+
+		while (size > WireDataSize)
+		{
+			size >>= 1;
+		}
+
+		return size;
+	}
+
+	void StartWrite(const StorageAddress address, const uint8_t* data, const uint8_t length)
+	{
+		if (!IsAddressable(address))
+		{
+			return;
+		}
+
+		Wire.beginTransmission(GetControlAddress(address));
+		Wire.write((uint8_t)(address >> 8));
+		Wire.write((uint8_t)address);
+		Wire.write(data, length);
+		Wire.endTransmission();
+	}
+
+	const uint8_t Read(const StorageAddress address)
+	{
+		if (!IsAddressable(address))
+		{
+			return UINT8_MAX;
+		}
+
+		const uint8_t controlAddress = GetControlAddress(address);
+
+		Wire.beginTransmission(controlAddress);
+		Wire.write((uint8_t)(address >> 8));
+		Wire.write((uint8_t)address);
+		Wire.endTransmission(false);
+
+		if (Wire.requestFrom(controlAddress, (uint8_t)1) == 1)
+		{
+			return Wire.read();
+		}
+
+		return UINT8_MAX;
+	}
+
+private:
+	/// <summary>
+	/// 2 address bytes, plus the 24LC1025 block select bit with EEPROM_ADDRESS_32.
+	/// </summary>
+	static constexpr bool IsAddressable(const StorageAddress address)
+	{
+#if defined(EEPROM_ADDRESS_32)
+		return address < ((uint32_t)1 << 17);
+#else
+		return true;
+#endif
+	}
+
+	/// <summary>
+	/// I2C address for the memory address, address bit 16 goes in the control byte's B0 bit.
+	/// </summary>
+	const uint8_t GetControlAddress(const StorageAddress address) const
+	{
+#if defined(EEPROM_ADDRESS_32)
+		return DeviceAddress | (uint8_t)(((address >> 16) & 1) << 2);
+#else
+		return DeviceAddress;
+#endif
+	}
+};
+#endif
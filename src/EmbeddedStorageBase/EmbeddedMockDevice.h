@@ -0,0 +1,171 @@
+#ifndef _EMBEDDED_MOCK_DEVICE_
+#define _EMBEDDED_MOCK_DEVICE_
+
+#include <stdint.h>
+#include <string.h>
+#include "EmbeddedDeviceProfile.h"
+
+// Device selection is per thread on the host, for parallel test suites.
+#if defined(__AVR__)
+#define EEPROM_MOCK_THREAD_LOCAL
+#else
+#define EEPROM_MOCK_THREAD_LOCAL thread_local
+#endif
+
+/// <summary>
+/// In-memory EEPROM device instance, with its own memory, timings and simulated clock.
+/// EmbeddedEEPROM operations go to the calling thread's selected device,
+///  or to the default EEPROM_MOCK_PROFILE device if none is selected.
+/// </summary>
+class MockEepromDevice
+{
+public:
+	uint8_t* const Memory;
+	const uint32_t Capacity;
+
+	const uint16_t ReadMicros;
+	const uint16_t EraseWriteMicros;
+	const uint16_t EraseMicros;
+	const uint16_t WriteMicros;
+
+	EmbeddedEEPROMClock Clock{};
+
+public:
+	MockEepromDevice(uint8_t* memory, const uint32_t capacity,
+		const uint16_t readMicros, const uint16_t eraseWriteMicros,
+		const uint16_t eraseMicros, const uint16_t writeMicros)
+		: Memory(memory)
+		, Capacity(capacity)
+		, ReadMicros(readMicros)
+		, EraseWriteMicros(eraseWriteMicros)
+		, EraseMicros(eraseMicros)
+		, WriteMicros(writeMicros)
+	{}
+
+	void Erase()
+	{
+		memset(Memory, UINT8_MAX, Capacity);
+	}
+
+	/// <summary>
+	/// Selects the device for the calling thread.
+	/// </summary>
+	/// <param name="device">Device, nullptr for the default device.</param>
+	static void Select(MockEepromDevice* device)
+	{
+		GetSelected() = device;
+	}
+
+	static MockEepromDevice*& GetSelected()
+	{
+		static EEPROM_MOCK_THREAD_LOCAL MockEepromDevice* selected = nullptr;
+
+		return selected;
+	}
+};
+
+/// <summary>
+/// MockEepromDevice with the capacity and timings of DeviceProfile.
+/// Starts erased.
+/// </summary>
+/// <typeparam name="DeviceProfile">Device traits, i.e. DeviceProfileATmega328P.</typeparam>
+template<typename DeviceProfile>
+class TemplateMockEepromDevice : public MockEepromDevice
+{
+private:
+	uint8_t Storage[DeviceProfile::Capacity];
+
+public:
+	TemplateMockEepromDevice()
+		: MockEepromDevice(Storage, DeviceProfile::Capacity,
+			DeviceProfile::ReadMicros, DeviceProfile::EraseWriteMicros,
+			DeviceProfile::EraseMicros, DeviceProfile::WriteMicros)
+	{
+		Erase();
+	}
+};
+
+/// <summary>
+/// Shared simulated I2C bus time, for MockStripeDevice.
+/// Bus transfers are serialized, write cycles run concurrently inside each device.
+/// </summary>
+struct MockStripeBus
+{
+	uint32_t ElapsedMicros;
+};
+
+/// <summary>
+/// Host simulation of an external EEPROM, for StripedWriteScheduler.
+/// Wraps a MockEepromDevice's memory, timings and operation counts.
+/// A byte read takes the device's ReadMicros of bus time (5 bus bytes), an ACK poll PollMicros.
+/// A page write takes 3 + length bus bytes, and keeps the device busy for one EraseWriteMicros.
+/// Accesses beyond the device's capacity are refused: writes are dropped, reads return 0xFF.
+/// </summary>
+class MockStripeDevice
+{
+public:
+	static constexpr uint16_t PollMicros = 25;
+
+private:
+	MockEepromDevice& Device;
+	MockStripeBus& Bus;
+	const uint8_t PageSize;
+	uint32_t BusyUntil = 0;
+
+public:
+	/// <param name="pageSize">Page size, 1 for byte writes only.</param>
+	MockStripeDevice(MockEepromDevice& device, MockStripeBus& bus, const uint8_t pageSize)
+		: Device(device)
+		, Bus(bus)
+		, PageSize(pageSize)
+	{}
+
+	void Begin() {}
+
+	const uint8_t GetPageSize() const
+	{
+		return PageSize;
+	}
+
+	const bool IsBusy()
+	{
+		Bus.ElapsedMicros += PollMicros;
+
+		return (int32_t)(BusyUntil - Bus.ElapsedMicros) > 0;
+	}
+
+	void StartWrite(const uint32_t address, const uint8_t* data, const uint8_t length)
+	{
+		Bus.ElapsedMicros += ((uint32_t)Device.ReadMicros * (3 + length)) / 5;
+
+		if (address >= Device.Capacity
+			|| length > (Device.Capacity - address))
+		{
+			Device.Clock.Refused++;
+			return;
+		}
+
+		BusyUntil = Bus.ElapsedMicros + Device.EraseWriteMicros;
+
+		Device.Clock.EraseWrites++;
+		Device.Clock.ElapsedMicros += Device.EraseWriteMicros;
+		memcpy(&Device.Memory[address], data, length);
+	}
+
+	const uint8_t Read(const uint32_t address)
+	{
+		Bus.ElapsedMicros += Device.ReadMicros;
+
+		if (address >= Device.Capacity)
+		{
+			Device.Clock.Refused++;
+			return UINT8_MAX;
+		}
+
+		Device.Clock.Reads++;
+		Device.Clock.ElapsedMicros += Device.ReadMicros;
+
+		return Device.Memory[address];
+	}
+};
+#endif
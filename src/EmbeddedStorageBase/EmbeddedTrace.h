@@ -0,0 +1,169 @@
+#ifndef _EMBEDDED_TRACE_
+#define _EMBEDDED_TRACE_
+
+#include <Arduino.h>
+#include <StorageAddressType.h>
+
+// Trace ring buffer size, in entries, from 1 to 255.
+// The oldest entries are overwritten when full.
+#if !defined(EEPROM_TRACE_SIZE)
+#define EEPROM_TRACE_SIZE 32
+#endif
+
+// Trace timestamp source, in milliseconds.
+#if !defined(EEPROM_TRACE_CLOCK)
+#define EEPROM_TRACE_CLOCK() millis()
+#endif
+
+/// <summary>
+/// Traced EEPROM operations.
+/// Values are the exported operation characters.
+/// </summary>
+enum class TraceOperation : uint8_t
+{
+	/// <summary>
+	/// Unit slot write start, at the slot address. Marks one logical write.
+	/// </summary>
+	Slot = 'S',
+
+	/// <summary>
+	/// Erase and write of a changed byte.
+	/// </summary>
+	EraseWrite = 'W',
+
+	/// <summary>
+	/// Erase only, to ones.
+	/// </summary>
+	Erase = 'E',
+
+	/// <summary>
+	/// Write only, zero bits programmed.
+	/// </summary>
+	Write = 'P'
+};
+
+struct TraceEntry
+{
+	uint32_t Timestamp;
+	StorageAddress Address;
+	TraceOperation Operation;
+};
+
+/// <summary>
+/// RAM ring buffer of wearing EEPROM operations, for field data capture.
+/// Reads and skipped updates are not traced.
+/// Export() the trace over a Stream, as "Operation,Address,Timestamp" lines,
+///  for replay with extras/WearSimulator.
+/// </summary>
+class EmbeddedTrace
+{
+private:
+	static_assert(EEPROM_TRACE_SIZE > 0 && EEPROM_TRACE_SIZE <= UINT8_MAX, "EEPROM_TRACE_SIZE must be from 1 to 255, Start and Count are 8 bit.");
+
+	struct TraceBuffer
+	{
+		TraceEntry Entries[EEPROM_TRACE_SIZE];
+		uint8_t Start;
+		uint8_t Count;
+		uint16_t Dropped;
+	};
+
+	static TraceBuffer& GetBuffer()
+	{
+		static TraceBuffer buffer{};
+
+		return buffer;
+	}
+
+public:
+	static void Record(const TraceOperation operation, const StorageAddress address)
+	{
+		TraceBuffer& buffer = GetBuffer();
+		TraceEntry& entry = buffer.Entries[(buffer.Start + buffer.Count) % EEPROM_TRACE_SIZE];
+
+		entry.Timestamp = EEPROM_TRACE_CLOCK();
+		entry.Address = address;
+		entry.Operation = operation;
+
+		if (buffer.Count < EEPROM_TRACE_SIZE)
+		{
+			buffer.Count++;
+		}
+		else
+		{
+			buffer.Start = (buffer.Start + 1) % EEPROM_TRACE_SIZE;
+			buffer.Dropped++;
+		}
+	}
+
+	/// <summary>
+	/// Takes the oldest traced entry.
+	/// </summary>
+	/// <param name="entry">Oldest entry.</param>
+	/// <returns>True if an entry was traced.</returns>
+	static const bool Take(TraceEntry& entry)
+	{
+		TraceBuffer& buffer = GetBuffer();
+
+		if (buffer.Count == 0)
+		{
+			return false;
+		}
+
+		entry = buffer.Entries[buffer.Start];
+		buffer.Start = (buffer.Start + 1) % EEPROM_TRACE_SIZE;
+		buffer.Count--;
+
+		return true;
+	}
+
+	static const uint8_t GetCount()
+	{
+		return GetBuffer().Count;
+	}
+
+	/// <summary>
+	/// Number of entries overwritten before being taken.
+	/// </summary>
+	static const uint16_t GetDropped()
+	{
+		return GetBuffer().Dropped;
+	}
+
+	static void Clear()
+	{
+		GetBuffer() = TraceBuffer{};
+	}
+
+	/// <summary>
+	/// Takes and prints all traced entries, oldest first.
+	/// Dropped entries are reported in a leading # comment line.
+	/// </summary>
+	/// <param name="stream">Target stream.</param>
+	/// <returns>Number of exported entries.</returns>
+	static const uint8_t Export(Stream& stream)
+	{
+		TraceEntry entry;
+		uint8_t count = 0;
+
+		if (GetDropped() > 0)
+		{
+			stream.print(F("#Dropped,"));
+			stream.println(GetDropped());
+			GetBuffer().Dropped = 0;
+		}
+
+		while (Take(entry))
+		{
+			stream.print((char)entry.Operation);
+			stream.print(',');
+			stream.print(entry.Address);
+			stream.print(',');
+			stream.println(entry.Timestamp);
+			count++;
+		}
+
+		return count;
+	}
+};
+#endif
@@ -0,0 +1,424 @@
+#ifndef _STORAGE_ENGINE_
+#define _STORAGE_ENGINE_
+
+#include "EmbeddedEEPROM.h"
+#include "EmbeddedCrc.h"
+#include "EmbeddedEcc.h"
+
+/// <summary>
+/// Shared, non-templated storage engine.
+/// Unit templates are thin typed facades over these functions,
+///  passing address, size, key and levels as run-time constants.
+/// Only one copy of the read/write/CRC/counter code is linked, regardless of unit count.
+/// </summary>
+class StorageEngine
+{
+public:
+	/// <summary>
+	/// Reads a ||Data|CRC|| slot into target array.
+	/// </summary>
+	/// <param name="slotAddress">Slot start address.</param>
+	/// <param name="target">Target array.</param>
+	/// <param name="dataSize">Data size in bytes.</param>
+	/// <param name="key">Storage cryptographic salt key.</param>
+	/// <param name="salt">CRC salt, the wear level counter.</param>
+	/// <returns>True if CRC matches.</returns>
+	static const bool ReadSlot(const StorageAddress slotAddress, uint8_t* target, const uint16_t dataSize,
+		const uint32_t key, const uint8_t salt)
+	{
+		KeyedCrc crc{};
+
+		for (uint16_t i = 0; i < dataSize; i++)
+		{
+			target[i] = EmbeddedEEPROM::ReadBlock(slotAddress + i);
+		}
+
+		return crc.GetCrc(target, dataSize, key, salt) == EmbeddedEEPROM::ReadBlock(slotAddress + dataSize);
+	}
+
+	/// <summary>
+	/// Writes a ||Data|CRC|| slot from source array.
+	/// </summary>
+	/// <param name="slotAddress">Slot start address.</param>
+	/// <param name="source">Source array.</param>
+	/// <param name="dataSize">Data size in bytes.</param>
+	/// <param name="key">Storage cryptographic salt key.</param>
+	/// <param name="salt">CRC salt, the wear level counter.</param>
+	/// <returns>Written CRC.</returns>
+	static const uint8_t WriteSlot(const StorageAddress slotAddress, const uint8_t* source, const uint16_t dataSize,
+		const uint32_t key, const uint8_t salt)
+	{
+		KeyedCrc crc{};
+
+#if defined(EEPROM_TRACE)
+		EmbeddedTrace::Record(TraceOperation::Slot, slotAddress);
+#endif
+		for (uint16_t i = 0; i < dataSize; i++)
+		{
+			EmbeddedEEPROM::WriteBlock(slotAddress + i, source[i]);
+		}
+
+		const uint8_t storedCrc = crc.GetCrc(source, dataSize, key, salt);
+		EmbeddedEEPROM::WriteBlock(slotAddress + dataSize, storedCrc);
+
+		return storedCrc;
+	}
+
+	/// <summary>
+	/// Validates a ||Data|CRC|| slot straight from EEPROM, with no RAM buffer.
+	/// </summary>
+	/// <param name="slotAddress">Slot start address.</param>
+	/// <param name="dataSize">Data size in bytes.</param>
+	/// <param name="key">Storage cryptographic salt key.</param>
+	/// <param name="salt">CRC salt, the wear level counter.</param>
+	/// <returns>True if CRC matches.</returns>
+	static const bool VerifySlot(const StorageAddress slotAddress, const uint16_t dataSize,
+		const uint32_t key, const uint8_t salt)
+	{
+		KeyedCrc crc{};
+
+		crc.Start();
+		for (uint16_t i = 0; i < dataSize; i++)
+		{
+			crc.Add(EmbeddedEEPROM::ReadBlock(slotAddress + i));
+		}
+
+		return crc.Finish(key, salt) == EmbeddedEEPROM::ReadBlock(slotAddress + dataSize);
+	}
+
+	/// <summary>
+	/// Invalidates a ||Data|CRC|| slot by storing the complement of its CRC.
+	/// Only the CRC byte is written, and only if it differs.
+	/// The complement differs in every bit, so ErrorCorrection::Secded can't correct it back.
+	/// </summary>
+	/// <param name="slotAddress">Slot start address.</param>
+	/// <param name="dataSize">Data size in bytes.</param>
+	/// <param name="key">Storage cryptographic salt key.</param>
+	/// <param name="salt">CRC salt, the wear level counter.</param>
+	static void InvalidateSlot(const StorageAddress slotAddress, const uint16_t dataSize,
+		const uint32_t key, const uint8_t salt)
+	{
+		KeyedCrc crc{};
+
+		crc.Start();
+		for (uint16_t i = 0; i < dataSize; i++)
+		{
+			crc.Add(EmbeddedEEPROM::ReadBlock(slotAddress + i));
+		}
+
+		EmbeddedEEPROM::WriteBlock(slotAddress + dataSize, (uint8_t)~crc.Finish(key, salt));
+	}
+
+	/// <summary>
+	/// Corrects a ||Data|CRC|Parity...|| slot, after a CRC mismatch on ReadSlot.
+	/// Corrected in RAM, EEPROM is only repaired if the CRC matches after correction:
+	///  an uncorrectable, blank or garbage slot is never written.
+	/// Only linked in by units with ErrorCorrection::Secded.
+	/// </summary>
+	/// <param name="slotAddress">Slot start address.</param>
+	/// <param name="target">Target array, as read.</param>
+	/// <param name="dataSize">Data size in bytes.</param>
+	/// <param name="key">Storage cryptographic salt key.</param>
+	/// <param name="salt">CRC salt, the wear level counter.</param>
+	/// <param name="corrections">Number of corrected blocks.</param>
+	/// <returns>True if CRC matches after correction.</returns>
+	static const bool CorrectSlot(const StorageAddress slotAddress, uint8_t* target, const uint16_t dataSize,
+		const uint32_t key, const uint8_t salt, uint8_t& corrections)
+	{
+		KeyedCrc crc{};
+		uint8_t storedCrc = EmbeddedEEPROM::ReadBlock(slotAddress + dataSize);
+		const uint8_t previous = corrections;
+
+		if (!EmbeddedEcc::CorrectSlot(slotAddress, target, dataSize, storedCrc, corrections)
+			|| crc.GetCrc(target, dataSize, key, salt) != storedCrc)
+		{
+			return false;
+		}
+
+		if (corrections != previous)
+		{
+			EmbeddedEcc::RepairSlot(slotAddress, target, dataSize, storedCrc);
+		}
+
+		return true;
+	}
+
+public:
+	/// <summary>
+	/// Bus-invert slot flag size, 1 bit for each Data and CRC block.
+	/// </summary>
+	static constexpr uint16_t GetInvertFlagsSize(const uint16_t dataSize)
+	{
+		return (dataSize + 1 + 7) / 8;
+	}
+
+	/// <summary>
+	/// Reads a bus-invert encoded ||Data|CRC|Flags...|| slot into target array.
+	/// A cleared flag bit marks an inverted block.
+	/// </summary>
+	/// <param name="slotAddress">Slot start address.</param>
+	/// <param name="target">Target array.</param>
+	/// <param name="dataSize">Data size in bytes.</param>
+	/// <param name="key">Storage cryptographic salt key.</param>
+	/// <param name="salt">CRC salt.</param>
+	/// <returns>True if CRC matches.</returns>
+	static const bool ReadInvertSlot(const StorageAddress slotAddress, uint8_t* target, const uint16_t dataSize,
+		const uint32_t key, const uint8_t salt)
+	{
+		KeyedCrc crc{};
+		const StorageAddress flagsAddress = slotAddress + dataSize + 1;
+		uint8_t flags = 0;
+		uint8_t storedCrc = 0;
+
+		for (uint16_t i = 0; i <= dataSize; i++)
+		{
+			if ((i % 8) == 0)
+			{
+				flags = EmbeddedEEPROM::ReadBlock(flagsAddress + (i / 8));
+			}
+
+			uint8_t value = EmbeddedEEPROM::ReadBlock(slotAddress + i);
+			if ((flags & (1 << (i % 8))) == 0)
+			{
+				value = ~value;
+			}
+
+			if (i < dataSize)
+			{
+				target[i] = value;
+			}
+			else
+			{
+				storedCrc = value;
+			}
+		}
+
+		return crc.GetCrc(target, dataSize, key, salt) == storedCrc;
+	}
+
+	/// <summary>
+	/// Writes a bus-invert encoded ||Data|CRC|Flags...|| slot from source array.
+	/// Each block is stored as-is or inverted, whichever needs fewer erases over the stored byte.
+	/// On a tie, the block keeps its previous encoding, so its flag bit is unchanged.
+	/// </summary>
+	/// <param name="slotAddress">Slot start address.</param>
+	/// <param name="source">Source array.</param>
+	/// <param name="dataSize">Data size in bytes.</param>
+	/// <param name="key">Storage cryptographic salt key.</param>
+	/// <param name="salt">CRC salt.</param>
+	static void WriteInvertSlot(const StorageAddress slotAddress, const uint8_t* source, const uint16_t dataSize,
+		const uint32_t key, const uint8_t salt)
+	{
+		KeyedCrc crc{};
+		const StorageAddress flagsAddress = slotAddress + dataSize + 1;
+		const uint8_t storedCrc = crc.GetCrc(source, dataSize, key, salt);
+		uint8_t previousFlags = 0;
+		uint8_t flags = 0;
+
+#if defined(EEPROM_TRACE)
+		EmbeddedTrace::Record(TraceOperation::Slot, slotAddress);
+#endif
+		for (uint16_t i = 0; i <= dataSize; i++)
+		{
+			const uint8_t bit = 1 << (i % 8);
+
+			if ((i % 8) == 0)
+			{
+				previousFlags = EmbeddedEEPROM::ReadBlock(flagsAddress + (i / 8));
+				flags = previousFlags;
+			}
+
+			const uint8_t value = (i < dataSize) ? source[i] : storedCrc;
+			const uint8_t current = EmbeddedEEPROM::ReadBlock(slotAddress + i);
+			const uint8_t plainCost = EmbeddedEEPROM::GetWriteCost(current, value);
+			const uint8_t invertCost = EmbeddedEEPROM::GetWriteCost(current, (uint8_t)~value);
+
+			if (invertCost < plainCost
+				|| (invertCost == plainCost && (previousFlags & bit) == 0))
+			{
+				flags &= ~bit;
+				EmbeddedEEPROM::ProgramBlock(slotAddress + i, ~value);
+			}
+			else
+			{
+				flags |= bit;
+				EmbeddedEEPROM::ProgramBlock(slotAddress + i, value);
+			}
+
+			if ((i % 8) == 7 || i == dataSize)
+			{
+				EmbeddedEEPROM::ProgramBlock(flagsAddress + (i / 8), flags);
+			}
+		}
+	}
+
+public:
+	/// <summary>
+	/// Unary wear level counter, over counterSize bytes.
+	/// The counter is the number of leading zero bits, most significant byte last.
+	/// Counting up only programs zeros, there is no erase until the counter rolls over.
+	/// </summary>
+	/// <param name="counterAddress">Counter start address.</param>
+	/// <param name="counterSize">Counter size in bytes, from 1 to 8.</param>
+	/// <param name="levels">Wear level option.</param>
+	/// <returns>Current counter, from 0 to levels - 1.</returns>
+	static const uint8_t GetCounter(const StorageAddress counterAddress, const uint8_t counterSize, const uint8_t levels)
+	{
+		const uint8_t zeros = GetLeadingZeros(counterAddress, counterSize);
+
+		if (zeros < levels)
+		{
+			return zeros;
+		}
+		else
+		{
+			return levels - 1;
+		}
+	}
+
+	/// <summary>
+	/// Increments the counter in a flash compatible way.
+	/// </summary>
+	/// <param name="counterAddress">Counter start address.</param>
+	/// <param name="counterSize">Counter size in bytes, from 1 to 8.</param>
+	/// <param name="levels">Wear level option.</param>
+	/// <returns>Current Counter</returns>
+	static const uint8_t IncrementCounter(const StorageAddress counterAddress, const uint8_t counterSize, const uint8_t levels)
+	{
+		const uint8_t counter = GetNextCounter(GetCounter(counterAddress, counterSize, levels), levels);
+
+		CommitCounter(counterAddress, counterSize, counter);
+
+		return counter;
+	}
+
+	/// <summary>
+	/// Counter after an increment, rolling over to 0.
+	/// </summary>
+	static constexpr uint8_t GetNextCounter(const uint8_t counter, const uint8_t levels)
+	{
+		return ((counter + 1) >= levels) ? 0 : (counter + 1);
+	}
+
+	/// <summary>
+	/// Stores the counter, from GetNextCounter().
+	/// 0 erases the counter, otherwise only the missing zeros are programmed.
+	/// The erase starts from the most significant byte, an interrupted erase is never unary:
+	///  it reads as 0 or fails validation, never as an older counter.
+	/// </summary>
+	/// <param name="counterAddress">Counter start address.</param>
+	/// <param name="counterSize">Counter size in bytes, from 1 to 8.</param>
+	/// <param name="counter">Counter, 0 or above the stored counter.</param>
+	static void CommitCounter(const StorageAddress counterAddress, const uint8_t counterSize, const uint8_t counter)
+	{
+		if (counter == 0)
+		{
+			for (uint8_t i = counterSize; i > 0; i--)
+			{
+				EmbeddedEEPROM::ClearByteToOnes(counterAddress + i - 1);
+			}
+		}
+		else
+		{
+			for (uint8_t i = 0; i < counterSize; i++)
+			{
+				const uint8_t mask = GetCounterByte(counter, counterSize, i);
+				if (mask != EmbeddedEEPROM::ReadBlock(counterAddress + i))
+				{
+					EmbeddedEEPROM::ProgramZeroBitsToZero(counterAddress + i, mask);
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// Validates the counter mask is unary: leading zeros followed by ones only.
+	/// </summary>
+	static const bool ValidateCounter(const StorageAddress counterAddress, const uint8_t counterSize)
+	{
+		bool ones = false;
+		for (uint8_t i = counterSize; i > 0; i--)
+		{
+			const uint8_t value = EmbeddedEEPROM::ReadBlock(counterAddress + i - 1);
+			if (ones)
+			{
+				if (value != UINT8_MAX)
+				{
+					return false;
+				}
+			}
+			else if (value > 0)
+			{
+				if ((uint8_t)(value & (value + 1)) != 0)
+				{
+					return false;
+				}
+				ones = true;
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Programs all counter bits to zero, the last level.
+	/// The next increment rolls over to the first level.
+	/// </summary>
+	static void ResetCounter(const StorageAddress counterAddress, const uint8_t counterSize)
+	{
+		for (uint8_t i = 0; i < counterSize; i++)
+		{
+			EmbeddedEEPROM::ProgramZeroBitsToZero(counterAddress + i, 0);
+		}
+	}
+
+	/// <summary>
+	/// Raw counter mask, for debugging.
+	/// </summary>
+	static const uint64_t GetCounterMask(const StorageAddress counterAddress, const uint8_t counterSize)
+	{
+		uint64_t mask = 0;
+		for (uint8_t i = counterSize; i > 0; i--)
+		{
+			mask = (mask << 8) | EmbeddedEEPROM::ReadBlock(counterAddress + i - 1);
+		}
+
+		return mask;
+	}
+
+private:
+	static const uint8_t GetLeadingZeros(const StorageAddress counterAddress, const uint8_t counterSize)
+	{
+		uint8_t zeros = 0;
+		for (uint8_t i = counterSize; i > 0; i--)
+		{
+			uint8_t value = EmbeddedEEPROM::ReadBlock(counterAddress + i - 1);
+			if (value == 0)
+			{
+				zeros += 8;
+			}
+			else
+			{
+				while ((value & 0b10000000) == 0)
+				{
+					zeros++;
+					value <<= 1;
+				}
+				break;
+			}
+		}
+
+		return zeros;
+	}
+
+	/// <summary>
+	/// Counter mask byte at index, with the counter's leading bits cleared.
+	/// </summary>
+	static constexpr uint8_t GetCounterByte(const uint8_t counter, const uint8_t counterSize, const uint8_t index)
+	{
+		return (counter <= ((counterSize - 1 - index) * 8)) ? UINT8_MAX
+			: ((counter - ((counterSize - 1 - index) * 8)) >= 8) ? 0
+			: (uint8_t)(UINT8_MAX >> (counter - ((counterSize - 1 - index) * 8)));
+	}
+};
+#endif
@@ -0,0 +1,23 @@
+#ifndef _ERROR_CORRECTION_TYPE_
+#define _ERROR_CORRECTION_TYPE_
+
+#include <stdint.h>
+
+/// <summary>
+/// Error correction options, on top of CRC detection.
+/// </summary>
+enum class ErrorCorrection : uint8_t
+{
+	/// <summary>
+	/// CRC detection only.
+	/// </summary>
+	None = 0,
+
+	/// <summary>
+	/// Hamming SECDED, 1 parity byte for every 8 bytes of Data and CRC.
+	/// Single bit errors per block are corrected, double bit errors are detected.
+	/// </summary>
+	Secded = 1
+};
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef _LOCKED_UNIT_
+#define _LOCKED_UNIT_
+
+#include <stdint.h>
+
+// std::mutex lock policy, available by default on hosts.
+// Define for Arduino targets with threading support in their standard library, i.e. ESP32.
+// #define EEPROM_LOCK_MUTEX
+#if !defined(ARDUINO) || defined(EEPROM_LOCK_MUTEX)
+#include <mutex>
+#endif
+
+/// <summary>
+/// No locking, for single threaded use.
+/// Lock policies provide Lock() and Unlock(),
+///  i.e. wrapping an RTOS mutex (xSemaphoreTake/xSemaphoreGive).
+/// </summary>
+struct NoLockPolicy
+{
+	void Lock() {}
+	void Unlock() {}
+};
+
+#if !defined(ARDUINO) || defined(EEPROM_LOCK_MUTEX)
+/// <summary>
+/// std::mutex lock, for multi-threaded hosts and RTOS with a C++11 standard library.
+/// </summary>
+struct MutexLockPolicy
+{
+	std::mutex Mutex{};
+
+	void Lock()
+	{
+		Mutex.lock();
+	}
+
+	void Unlock()
+	{
+		Mutex.unlock();
+	}
+};
+#endif
+
+enum class LockedRead : uint8_t
+{
+	/// <summary>
+	/// Readers take the unit's lock, same as writers.
+	/// </summary>
+	Locked,
+
+	/// <summary>
+	/// Readers never block the writer, they read the last committed slot.
+	/// Wear level units only, see BaseWearLevelUnit::ReadCommitted().
+	/// </summary>
+	Committed
+};
+
+/// <summary>
+/// Lock shared by every LockedUnit over the same unit, whatever the ReadMode.
+/// The unit itself is stateless, so the lock is keyed on UnitType and LockPolicy only.
+/// </summary>
+/// <typeparam name="UnitType">Unit type, i.e. TinyWearLevelUnit.</typeparam>
+/// <typeparam name="LockPolicy">Lock type, i.e. MutexLockPolicy.</typeparam>
+template<typename UnitType,
+	typename LockPolicy>
+class UnitLock
+{
+public:
+	static LockPolicy& Get()
+	{
+		static LockPolicy lock{};
+
+		return lock;
+	}
+};
+
+/// <summary>
+/// Thread-safe wrapper for any unit.
+/// Each unit type has its own lock, there is no global lock: writes to different units run concurrently.
+/// Counter read-modify-write and slot writes of the same unit are serialized.
+/// The unit itself is stateless, so every LockedUnit over UnitType shares the lock, see UnitLock.
+/// The unit is a private base, only the locked members below are exposed.
+/// </summary>
+/// <typeparam name="UnitType">Unit type, i.e. TinyWearLevelUnit.</typeparam>
+/// <typeparam name="LockPolicy">Lock type, i.e. MutexLockPolicy.</typeparam>
+/// <param name="ReadMode">LockedRead::Committed for lock-free readers, on wear level units.</param>
+template<typename UnitType,
+	typename LockPolicy,
+	const LockedRead ReadMode = LockedRead::Locked>
+class LockedUnit : private UnitType
+{
+public:
+	using UnitType::Address;
+	using UnitType::Size;
+	using UnitType::GetDataSize;
+
+public:
+	LockedUnit() : UnitType()
+	{}
+
+	void Begin()
+	{
+		Lock();
+		UnitType::Begin();
+		Unlock();
+	}
+
+	/// <summary>
+	/// Reads the declared DataSize into target array.
+	/// </summary>
+	/// <param name="target">Target array.</param>
+	/// <returns>True if CRC matches.</returns>
+	const bool ReadData(uint8_t* target)
+	{
+		return ReadData(target, ReadModeTag<ReadMode>());
+	}
+
+	/// <summary>
+	/// Writes the declared DataSize from source array.
+	/// </summary>
+	/// <param name="source">Source array.</param>
+	void WriteData(const uint8_t* source)
+	{
+		Lock();
+		UnitType::WriteData(source);
+		Unlock();
+	}
+
+	/// <summary>
+	/// Validates the current data's CRC.
+	/// </summary>
+	/// <returns>True if CRC matches.</returns>
+	const bool Verify()
+	{
+		Lock();
+		const bool valid = UnitType::Verify();
+		Unlock();
+
+		return valid;
+	}
+
+	/// <summary>
+	/// Invalidates the current data, reads fail until the next write.
+	/// </summary>
+	void Invalidate()
+	{
+		Lock();
+		UnitType::Invalidate();
+		Unlock();
+	}
+
+private:
+	template<const LockedRead mode>
+	struct ReadModeTag {};
+
+	const bool ReadData(uint8_t* target, ReadModeTag<LockedRead::Locked>)
+	{
+		Lock();
+		const bool valid = UnitType::ReadData(target);
+		Unlock();
+
+		return valid;
+	}
+
+	const bool ReadData(uint8_t* target, ReadModeTag<LockedRead::Committed>)
+	{
+		return UnitType::ReadCommitted(target);
+	}
+
+	static void Lock()
+	{
+		UnitLock<UnitType, LockPolicy>::Get().Lock();
+	}
+
+	static void Unlock()
+	{
+		UnitLock<UnitType, LockPolicy>::Get().Unlock();
+	}
+};
+#endif
@@ -0,0 +1,307 @@
+#ifndef _LOG_UNIT_
+#define _LOG_UNIT_
+
+#include "EmbeddedStorageBase\EmbeddedEEPROM.h"
+#include "EmbeddedStorageBase\EmbeddedCrc.h"
+#include <EmbeddedStorage.h>
+
+/// <summary>
+/// Circular record log, CRC checked EEPROM storage unit.
+/// Also usable as a persistent store-and-forward queue.
+/// Each record is CRC framed with a sequence tag.
+/// ||State|Sequence|Record...|CRC|| x Capacity
+/// Append costs a single record write, there is no index to rewrite.
+/// Head and tail are found on Begin() with a binary search over the sequence tags.
+/// Consume() acknowledges the oldest pending record by programming its State to zero, with no erase.
+/// When full, Append() overwrites the oldest record, pending or not.
+/// Unlike the other units, head, tail and sequence are kept in RAM, 8 bytes per instance.
+/// </summary>
+/// <param name="RecordSize">Record size in bytes.</param>
+/// <param name="Capacity">Number of records, from 2 to 32767.</param>
+/// <param name="Key">Storage cryptographic salt key.
+///  Changing the key invalidates any previous data.</param>
+template<const StorageAddress address,
+	const uint16_t RecordSize,
+	const uint16_t Capacity,
+	const uint32_t Key = RecordSize>
+class LogUnit
+{
+private:
+	static_assert(Capacity >= 2 && Capacity <= INT16_MAX, "Capacity must be from 2 to 32767.");
+
+	static constexpr uint8_t StatePending = UINT8_MAX;
+	static constexpr uint8_t StateConsumed = 0;
+
+	static constexpr uint16_t SequenceOffset = 1;
+	static constexpr uint16_t DataOffset = SequenceOffset + sizeof(uint16_t);
+	static constexpr uint16_t CrcOffset = DataOffset + RecordSize;
+	static constexpr uint16_t RecordStride = CrcOffset + 1;
+
+	static_assert(EmbeddedStorage::Fits(address, (uint32_t)Capacity * RecordStride), "Unit exceeds the StorageAddress range, enable EEPROM_ADDRESS_32.");
+
+private:
+	uint16_t Head = 0;
+	uint16_t Count = 0;
+	uint16_t Pending = 0;
+	uint16_t Sequence = 0;
+
+public:
+	static constexpr StorageAddress Address()
+	{
+		return address;
+	}
+
+	static constexpr StorageAddress Size()
+	{
+		return Capacity * RecordStride;
+	}
+
+	static constexpr uint16_t GetCapacity()
+	{
+		return Capacity;
+	}
+
+public:
+	/// <summary>
+	/// Finds head and tail, with a binary search over the record sequences.
+	/// Construction has no side effects, call once from setup().
+	/// </summary>
+	void Begin()
+	{
+		EEPROM.begin();
+		Initialize();
+	}
+
+	const uint16_t GetCount() const
+	{
+		return Count;
+	}
+
+	const uint16_t GetPendingCount() const
+	{
+		return Pending;
+	}
+
+	/// <summary>
+	/// Appends a new record, overwriting the oldest one if full.
+	/// </summary>
+	/// <param name="source">Source array, with RecordSize bytes.</param>
+	void Append(const uint8_t* source)
+	{
+		if (Count > 0)
+		{
+			Head = GetNextIndex(Head);
+			Sequence++;
+		}
+
+		if (Count < Capacity)
+		{
+			Count++;
+		}
+		else if (Pending == Capacity)
+		{
+			// Oldest pending record is overwritten.
+			Pending--;
+		}
+		Pending++;
+
+		const StorageAddress recordAddress = GetRecordAddress(Head);
+		EmbeddedCrc<Key> crc{};
+
+		EmbeddedEEPROM::WriteBlock(recordAddress, StatePending);
+		EmbeddedEEPROM::WriteBlock(recordAddress + SequenceOffset, Sequence & UINT8_MAX);
+		EmbeddedEEPROM::WriteBlock(recordAddress + SequenceOffset + 1, Sequence >> 8);
+		for (uint16_t i = 0; i < RecordSize; i++)
+		{
+			EmbeddedEEPROM::WriteBlock(recordAddress + DataOffset + i, source[i]);
+		}
+
+		crc.Start();
+		crc.Add(Sequence & UINT8_MAX);
+		crc.Add(Sequence >> 8);
+		crc.Add(source, RecordSize);
+		EmbeddedEEPROM::WriteBlock(recordAddress + CrcOffset, crc.Finish());
+	}
+
+	/// <summary>
+	/// Reads a record, newest first.
+	/// </summary>
+	/// <param name="age">0 for newest, up to GetCount() - 1 for oldest.</param>
+	/// <param name="target">Target array, with RecordSize bytes.</param>
+	/// <returns>True if record exists and CRC matches.</returns>
+	const bool ReadRecord(const uint16_t age, uint8_t* target)
+	{
+		if (age >= Count)
+		{
+			return false;
+		}
+
+		return ReadIndex((Head + Capacity - age) % Capacity, target);
+	}
+
+	/// <summary>
+	/// Reads the oldest pending record, without consuming it.
+	/// </summary>
+	/// <param name="target">Target array, with RecordSize bytes.</param>
+	/// <returns>True if a pending record exists and CRC matches.</returns>
+	const bool Peek(uint8_t* target)
+	{
+		if (Pending == 0)
+		{
+			return false;
+		}
+
+		return ReadRecord(Pending - 1, target);
+	}
+
+	/// <summary>
+	/// Acknowledges the oldest pending record.
+	/// Write-only operation, no erase needed.
+	/// </summary>
+	/// <returns>True if a pending record was consumed.</returns>
+	const bool Consume()
+	{
+		if (Pending == 0)
+		{
+			return false;
+		}
+
+		EmbeddedEEPROM::ProgramZeroBitsToZero(GetRecordAddress((Head + Capacity - (Pending - 1)) % Capacity), StateConsumed);
+		Pending--;
+
+		return true;
+	}
+
+private:
+	/// <summary>
+	/// Records hold consecutive sequences from the first valid index up to Head,
+	///  followed by the previous lap (or blank) records.
+	/// Only the record being written on reset can be torn.
+	/// </summary>
+	void Initialize()
+	{
+		Head = 0;
+		Count = 0;
+		Pending = 0;
+		Sequence = 0;
+
+		uint16_t base = 0;
+		if (!IsValid(0))
+		{
+			if (!IsValid(1))
+			{
+				// Empty log.
+				return;
+			}
+			base = 1;
+		}
+
+		// Binary search for the last record with a consecutive sequence.
+		const uint16_t baseSequence = GetSequence(base);
+		uint16_t low = base;
+		uint16_t high = Capacity - 1;
+		while (low < high)
+		{
+			const uint16_t middle = low + ((high - low + 1) / 2);
+			if (IsValid(middle)
+				&& GetSequence(middle) == (uint16_t)(baseSequence + (middle - base)))
+			{
+				low = middle;
+			}
+			else
+			{
+				high = middle - 1;
+			}
+		}
+
+		Head = low;
+		Sequence = GetSequence(Head);
+		Count = Head - base + 1;
+
+		// Previous lap records, tolerating a torn record after Head.
+		for (uint16_t skip = 1; skip <= 2; skip++)
+		{
+			const uint16_t index = Head + skip;
+			if (index < Capacity
+				&& IsValid(index)
+				&& GetSequence(index) == (uint16_t)(Sequence + skip - Capacity))
+			{
+				Count += Capacity - index;
+				break;
+			}
+		}
+
+		// Consumed records are a prefix, from oldest to newest.
+		uint16_t consumed = 0;
+		uint16_t remaining = Count;
+		while (remaining > 0)
+		{
+			const uint16_t step = remaining / 2;
+			const uint16_t age = Count - 1 - (consumed + step);
+			if (EmbeddedEEPROM::ReadBlock(GetRecordAddress((Head + Capacity - age) % Capacity)) != StatePending)
+			{
+				consumed += step + 1;
+				remaining -= step + 1;
+			}
+			else
+			{
+				remaining = step;
+			}
+		}
+		Pending = Count - consumed;
+	}
+
+	const bool ReadIndex(const uint16_t index, uint8_t* target)
+	{
+		const StorageAddress recordAddress = GetRecordAddress(index);
+		EmbeddedCrc<Key> crc{};
+
+		for (uint16_t i = 0; i < RecordSize; i++)
+		{
+			target[i] = EmbeddedEEPROM::ReadBlock(recordAddress + DataOffset + i);
+		}
+
+		crc.Start();
+		crc.Add(EmbeddedEEPROM::ReadBlock(recordAddress + SequenceOffset));
+		crc.Add(EmbeddedEEPROM::ReadBlock(recordAddress + SequenceOffset + 1));
+		crc.Add(target, RecordSize);
+
+		return crc.Finish() == EmbeddedEEPROM::ReadBlock(recordAddress + CrcOffset);
+	}
+
+	/// <summary>
+	/// Validates a record's CRC, straight from EEPROM.
+	/// </summary>
+	const bool IsValid(const uint16_t index)
+	{
+		const StorageAddress recordAddress = GetRecordAddress(index);
+		EmbeddedCrc<Key> crc{};
+
+		crc.Start();
+		for (uint16_t i = SequenceOffset; i < CrcOffset; i++)
+		{
+			crc.Add(EmbeddedEEPROM::ReadBlock(recordAddress + i));
+		}
+
+		return crc.Finish() == EmbeddedEEPROM::ReadBlock(recordAddress + CrcOffset);
+	}
+
+	const uint16_t GetSequence(const uint16_t index)
+	{
+		const StorageAddress recordAddress = GetRecordAddress(index);
+
+		return ((uint16_t)EmbeddedEEPROM::ReadBlock(recordAddress + SequenceOffset + 1) << 8)
+			| EmbeddedEEPROM::ReadBlock(recordAddress + SequenceOffset);
+	}
+
+	static constexpr StorageAddress GetRecordAddress(const uint16_t index)
+	{
+		return address + ((StorageAddress)index * RecordStride);
+	}
+
+	static constexpr uint16_t GetNextIndex(const uint16_t index)
+	{
+		return (index + 1) % Capacity;
+	}
+};
+#endif
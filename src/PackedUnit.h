@@ -0,0 +1,293 @@
+#ifndef _PACKED_UNIT_
+#define _PACKED_UNIT_
+
+#include <stdint.h>
+#include "EmbeddedStorageBase\EmbeddedHash.h"
+#include <StorageUnit.h>
+#include <WearLevelUnit.h>
+
+/// <summary>
+/// Bit-packed struct member, for PackedSchema.
+/// Stores (value - Minimum) in Bits bits, values outside the range are truncated.
+/// Use PACKED_MEMBER for bools, enums and unsigned values, PACKED_RANGE for offset and signed ranges.
+/// </summary>
+/// <typeparam name="StructType">Data struct type.</typeparam>
+/// <typeparam name="MemberType">Member type, up to 32 bits.</typeparam>
+/// <param name="Member">Pointer to member.</param>
+/// <param name="Bits">Stored bits, from 1 to 32.</param>
+/// <param name="Minimum">Value stored as 0.</param>
+template<typename StructType,
+	typename MemberType,
+	MemberType StructType::* Member,
+	const uint8_t Bits,
+	const int32_t Minimum = 0>
+struct PackedField
+{
+	static_assert(Bits > 0 && Bits <= 32, "Bits must be from 1 to 32.");
+	static_assert(sizeof(MemberType) <= sizeof(uint32_t), "MemberType must be up to 32 bits.");
+
+	static constexpr uint8_t BitCount = Bits;
+
+	static constexpr uint32_t Hash(const uint32_t hash)
+	{
+		return EmbeddedHash::Add32(EmbeddedHash::Add(hash, Bits), (uint32_t)Minimum);
+	}
+
+	static const uint32_t Get(const StructType& source)
+	{
+		return (uint32_t)((int32_t)(source.*Member) - Minimum);
+	}
+
+	static void Set(StructType& target, const uint32_t value)
+	{
+		target.*Member = (MemberType)((int32_t)value + Minimum);
+	}
+};
+
+/// <summary>
+/// Range bit count, for PACKED_RANGE.
+/// </summary>
+class PackedRange
+{
+public:
+	/// <summary>
+	/// Bits needed to store a range of span + 1 values.
+	/// </summary>
+	static constexpr uint8_t GetBits(const uint32_t span)
+	{
+		return (span <= 1) ? 1 : (1 + GetBits(span >> 1));
+	}
+};
+
+/// <summary>
+/// Member stored in Bits bits, i.e. PACKED_MEMBER(Settings, Enabled, 1).
+/// </summary>
+#define PACKED_MEMBER(StructType, Member, Bits) PackedField<StructType, decltype(StructType::Member), &StructType::Member, Bits>
+
+/// <summary>
+/// Member stored in the fewest bits for [Minimum, Maximum], i.e. PACKED_RANGE(Settings, Temperature, -40, 85).
+/// </summary>
+#define PACKED_RANGE(StructType, Member, Minimum, Maximum) PackedField<StructType, decltype(StructType::Member), &StructType::Member, PackedRange::GetBits((uint32_t)((int32_t)(Maximum) - (int32_t)(Minimum))), Minimum>
+
+/// <summary>
+/// Compile-time bit-packed serialization schema.
+/// Fields are packed in order, least significant bit first, with no padding between them.
+/// Size is the packed byte size, to use as the unit's DataSize.
+/// Key is a hash of every field's bits and range, to use as the unit's Key:
+///  a schema change invalidates the stored data, instead of unpacking it wrong.
+/// Example:
+///  using SettingsSchema = PackedSchema<Settings, PACKED_MEMBER(Settings, Enabled, 1), PACKED_RANGE(Settings, Temperature, -40, 85)>;
+///  PackedStorageUnit<0, SettingsSchema> unit{};
+/// </summary>
+/// <typeparam name="StructType">Data struct type.</typeparam>
+/// <typeparam name="...Fields">PACKED_MEMBER or PACKED_RANGE fields of StructType.</typeparam>
+template<typename StructType,
+	typename... Fields>
+class PackedSchema
+{
+private:
+	template<const size_t depth>
+	static constexpr uint16_t SumBits()
+	{
+		return 0;
+	}
+
+	template<const size_t depth,
+		typename First,
+		typename... Parameters>
+	static constexpr uint16_t SumBits()
+	{
+		return First::BitCount + SumBits<depth + 1, Parameters...>();
+	}
+
+	template<const size_t depth>
+	static constexpr uint32_t Hash(const uint32_t hash)
+	{
+		return hash;
+	}
+
+	template<const size_t depth,
+		typename First,
+		typename... Parameters>
+	static constexpr uint32_t Hash(const uint32_t hash)
+	{
+		return Hash<depth + 1, Parameters...>(First::Hash(hash));
+	}
+
+public:
+	using Type = StructType;
+
+	static constexpr uint16_t Bits = SumBits<0, Fields...>();
+
+	static constexpr uint16_t Size = (Bits + 7) / 8;
+
+	static constexpr uint32_t Key = Hash<0, Fields...>(EmbeddedHash::Add16(EmbeddedHash::Seed, Bits));
+
+	static_assert(Size > 0, "PackedSchema needs at least one field.");
+
+public:
+	/// <summary>
+	/// Packs source into buffer, unused trailing bits are cleared.
+	/// </summary>
+	/// <param name="source">Source struct.</param>
+	/// <param name="buffer">Target array, of Size bytes.</param>
+	static void Pack(const StructType& source, uint8_t* buffer)
+	{
+		for (uint16_t i = 0; i < Size; i++)
+		{
+			buffer[i] = 0;
+		}
+
+		uint16_t offset = 0;
+		const bool packed[] = { PackField<Fields>(source, buffer, offset)... };
+		(void)packed;
+	}
+
+	/// <summary>
+	/// Unpacks buffer into target's schema members, other members are untouched.
+	/// </summary>
+	/// <param name="buffer">Source array, of Size bytes.</param>
+	/// <param name="target">Target struct.</param>
+	static void Unpack(const uint8_t* buffer, StructType& target)
+	{
+		uint16_t offset = 0;
+		const bool unpacked[] = { UnpackField<Fields>(buffer, target, offset)... };
+		(void)unpacked;
+	}
+
+private:
+	template<typename Field>
+	static const bool PackField(const StructType& source, uint8_t* buffer, uint16_t& offset)
+	{
+		uint32_t value = Field::Get(source);
+
+		for (uint8_t bits = Field::BitCount; bits > 0;)
+		{
+			const uint8_t shift = offset % 8;
+			const uint8_t length = ((8 - shift) < bits) ? (8 - shift) : bits;
+
+			buffer[offset / 8] |= (uint8_t)((value & ((1 << length) - 1)) << shift);
+			value >>= length;
+			offset += length;
+			bits -= length;
+		}
+
+		return true;
+	}
+
+	template<typename Field>
+	static const bool UnpackField(const uint8_t* buffer, StructType& target, uint16_t& offset)
+	{
+		uint32_t value = 0;
+
+		for (uint8_t bits = 0; bits < Field::BitCount;)
+		{
+			const uint8_t shift = offset % 8;
+			const uint8_t length = ((8 - shift) < (Field::BitCount - bits)) ? (8 - shift) : (Field::BitCount - bits);
+
+			value |= (uint32_t)((buffer[offset / 8] >> shift) & ((1 << length) - 1)) << bits;
+			offset += length;
+			bits += length;
+		}
+
+		Field::Set(target, value);
+
+		return true;
+	}
+};
+
+/// <summary>
+/// Bit-packed wrapper for any unit declared with DataSize = PackedSchema::Size.
+/// Only the packed bytes are stored: fewer bytes to program per save,
+///  and more wear levels in the same space.
+/// Prefer PackedStorageUnit and the Packed*WearLevelUnit aliases, which take DataSize and Key from the schema.
+/// </summary>
+/// <typeparam name="UnitType">StorageUnit or a WearLevelUnit, with DataSize = Schema::Size and Key = Schema::Key.</typeparam>
+/// <typeparam name="Schema">PackedSchema.</typeparam>
+template<typename UnitType,
+	typename Schema>
+class PackedUnit : public UnitType
+{
+private:
+	static_assert(UnitType::GetDataSize() == Schema::Size, "UnitType must be declared with DataSize = Schema::Size.");
+
+public:
+	PackedUnit() : UnitType()
+	{}
+
+	/// <summary>
+	/// Reads and unpacks into target.
+	/// </summary>
+	/// <param name="target">Target struct, untouched if CRC doesn't match.</param>
+	/// <returns>True if CRC matches.</returns>
+	const bool ReadData(typename Schema::Type& target)
+	{
+		uint8_t buffer[Schema::Size];
+
+		if (UnitType::ReadData(buffer))
+		{
+			Schema::Unpack(buffer, target);
+
+			return true;
+		}
+
+		return false;
+	}
+
+	/// <summary>
+	/// Packs and writes source.
+	/// </summary>
+	/// <param name="source">Source struct.</param>
+	void WriteData(const typename Schema::Type& source)
+	{
+		uint8_t buffer[Schema::Size];
+
+		Schema::Pack(source, buffer);
+		UnitType::WriteData(buffer);
+	}
+};
+
+/// <summary>
+/// PackedUnit over a StorageUnit, with DataSize = Schema::Size and Key = Schema::Key.
+/// </summary>
+template<const StorageAddress address,
+	typename Schema,
+	const ErrorCorrection Correction = ErrorCorrection::None>
+using PackedStorageUnit = PackedUnit<StorageUnit<address, Schema::Size, Schema::Key, Correction>, Schema>;
+
+/// <summary>
+/// PackedUnit over a TinyWearLevelUnit, with DataSize = Schema::Size and Key = Schema::Key.
+/// </summary>
+template<const StorageAddress address,
+	typename Schema,
+	const WearLevelTiny Option = WearLevelTiny::x2,
+	const ErrorCorrection Correction = ErrorCorrection::None>
+using PackedTinyWearLevelUnit = PackedUnit<TinyWearLevelUnit<address, Schema::Size, Option, Schema::Key, Correction>, Schema>;
+
+/// <summary>
+/// PackedUnit over a ShortWearLevelUnit, with DataSize = Schema::Size and Key = Schema::Key.
+/// </summary>
+template<const StorageAddress address,
+	typename Schema,
+	const WearLevelShort Option = WearLevelShort::x10,
+	const ErrorCorrection Correction = ErrorCorrection::None>
+using PackedShortWearLevelUnit = PackedUnit<ShortWearLevelUnit<address, Schema::Size, Option, Schema::Key, Correction>, Schema>;
+
+/// <summary>
+/// PackedUnit over a LongWearLevelUnit, with DataSize = Schema::Size and Key = Schema::Key.
+/// </summary>
+template<const StorageAddress address,
+	typename Schema,
+	const WearLevelLong Option = WearLevelLong::x18,
+	const ErrorCorrection Correction = ErrorCorrection::None>
+using PackedLongWearLevelUnit = PackedUnit<LongWearLevelUnit<address, Schema::Size, Option, Schema::Key, Correction>, Schema>;
+
+/// <summary>
+/// PackedUnit over a LongLongWearLevelUnit, with DataSize = Schema::Size and Key = Schema::Key.
+/// </summary>
+template<const StorageAddress address,
+	typename Schema,
+	const WearLevelLongLong Option = WearLevelLongLong::x34,
+	const ErrorCorrection Correction = ErrorCorrection::None>
+using PackedLongLongWearLevelUnit = PackedUnit<LongLongWearLevelUnit<address, Schema::Size, Option, Schema::Key, Correction>, Schema>;
+#endif
@@ -0,0 +1,20 @@
+#ifndef _STORAGE_ADDRESS_TYPE_
+#define _STORAGE_ADDRESS_TYPE_
+
+#include <stdint.h>
+
+// Enables 32 bit addresses and sizes, for devices larger than 64 KB.
+// i.e. 24LC1025, FM24V10, 25-series.
+// Disabled by default, AVR internal EEPROM builds keep 16 bit code.
+// #define EEPROM_ADDRESS_32
+
+/// <summary>
+/// EEPROM address and size type.
+/// </summary>
+#if defined(EEPROM_ADDRESS_32)
+typedef uint32_t StorageAddress;
+#else
+typedef uint16_t StorageAddress;
+#endif
+
+#endif
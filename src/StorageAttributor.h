@@ -7,7 +7,7 @@
 template<size_t...Sizes>
 struct TemplateSizeAttributor
 {
-	static constexpr uint16_t GetUsed()
+	static constexpr StorageAddress GetUsed()
 	{
 		return SizeParameter::Sum(Sizes...);
 	}
@@ -32,13 +32,17 @@ struct TemplateSizeAttributor
 /// <summary>
 /// Assumes StorageTypes have a ::Size static property.
 /// Assumes StorageTypes have a ::WearLevelOption static property.
+/// StorageTypes may have an optional ::ErrorCorrectionOption static property.
 /// </summary>
 /// <typeparam name="...StorageTypes"></typeparam>
 template<typename... StorageTypes>
 struct TemplateStorageAttributor
 {
+private:
+	static_assert(EmbeddedStorage::Fits(0, StorageParameter::Sum<StorageTypes...>()), "Layout exceeds the StorageAddress range, enable EEPROM_ADDRESS_32.");
+
 public:
-	static constexpr uint16_t GetUsed()
+	static constexpr StorageAddress GetUsed()
 	{
 		return StorageParameter::Sum<StorageTypes...>();
 	}
@@ -48,37 +52,68 @@ public:
 		return StorageParameter::Count<StorageTypes...>();
 	}
 
-	static constexpr size_t GetAddress(const size_t storageIndex)
+	static constexpr StorageAddress GetAddress(const size_t storageIndex)
 	{
 		return StorageParameter::SumUpTo<StorageTypes...>(storageIndex);
 	}
 
-	static constexpr size_t GetAddressByKey(const uint32_t key)
+	static constexpr StorageAddress GetAddressByKey(const uint32_t key)
 	{
 		return StorageParameter::SumUpToKey<StorageTypes...>(key);
 	}
 
-	static constexpr size_t GetSize(const size_t storageIndex)
+	static constexpr StorageAddress GetSize(const size_t storageIndex)
 	{
 		return StorageParameter::Size<StorageTypes...>(storageIndex);
 	}
 
-	static constexpr size_t GetSizeByKey(const uint32_t key)
+	static constexpr StorageAddress GetSizeByKey(const uint32_t key)
 	{
 		return StorageParameter::SizeByKey<StorageTypes...>(key);
 	}
 
+	/// <summary>
+	/// Layout fingerprint.
+	/// Changes with any Key, Size, WearLevelOption or order change.
+	/// </summary>
+	static constexpr uint32_t GetFingerprint()
+	{
+		return StorageParameter::Fingerprint<StorageTypes...>();
+	}
+
+	/// <summary>
+	/// True if the layout fits in the device's capacity.
+	/// </summary>
+	template<typename DeviceProfile>
+	static constexpr bool FitsDevice()
+	{
+		return StorageParameter::Sum<StorageTypes...>() <= DeviceProfile::Capacity;
+	}
+
 	template<typename StorageType>
-	static constexpr size_t GetAddressByKey()
+	static constexpr StorageAddress GetAddressByKey()
 	{
 		return GetAddressByKey(StorageType::Key);
 	}
 
 	template<typename StorageType>
-	static constexpr size_t GetSizeByKey()
+	static constexpr StorageAddress GetSizeByKey()
 	{
 		return GetSizeByKey(StorageType::Key);
 	}
 };
 
+/// <summary>
+/// TemplateStorageAttributor, checked against a device profile's capacity at compile time.
+/// i.e. with StoragePlanner's PlannedDefinition, for an endurance and space budget.
+/// </summary>
+/// <typeparam name="DeviceProfile">Device traits, i.e. DeviceProfileATmega328P.</typeparam>
+/// <typeparam name="...StorageTypes"></typeparam>
+template<typename DeviceProfile, typename... StorageTypes>
+struct TemplateDeviceAttributor : TemplateStorageAttributor<StorageTypes...>
+{
+private:
+	static_assert(TemplateStorageAttributor<StorageTypes...>::template FitsDevice<DeviceProfile>(), "Layout exceeds the device capacity.");
+};
+
 #endif
\ No newline at end of file
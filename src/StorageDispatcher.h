@@ -0,0 +1,255 @@
+#ifndef _STORAGE_DISPATCHER_h
+#define _STORAGE_DISPATCHER_h
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "StorageAttributor.h"
+#include "StorageUnit.h"
+#include "WearLevelUnit.h"
+
+/// <summary>
+/// Run-time description of a storage unit, as stored in PROGMEM.
+/// </summary>
+struct StorageEntry
+{
+	uint32_t Key;
+	StorageAddress Address;
+	StorageAddress Size;
+	uint8_t WearLevelOption;
+	const bool (*Read)(uint8_t* target);
+	void (*Write)(const uint8_t* source);
+};
+
+/// <summary>
+/// Unit type for a storage definition, selected by its WearLevelOption type.
+/// </summary>
+template<typename WearLevelType>
+struct DefinitionUnit;
+
+template<>
+struct DefinitionUnit<const NoWearLevel>
+{
+	template<const StorageAddress address, typename Definition>
+	using Type = StorageUnit<address, Definition::Size, Definition::Key, StorageParameter::GetErrorCorrection<Definition>()>;
+};
+
+template<>
+struct DefinitionUnit<const WearLevelTiny>
+{
+	template<const StorageAddress address, typename Definition>
+	using Type = TinyWearLevelUnit<address, Definition::Size, Definition::WearLevelOption, Definition::Key, StorageParameter::GetErrorCorrection<Definition>()>;
+};
+
+template<>
+struct DefinitionUnit<const WearLevelShort>
+{
+	template<const StorageAddress address, typename Definition>
+	using Type = ShortWearLevelUnit<address, Definition::Size, Definition::WearLevelOption, Definition::Key, StorageParameter::GetErrorCorrection<Definition>()>;
+};
+
+template<>
+struct DefinitionUnit<const WearLevelLong>
+{
+	template<const StorageAddress address, typename Definition>
+	using Type = LongWearLevelUnit<address, Definition::Size, Definition::WearLevelOption, Definition::Key, StorageParameter::GetErrorCorrection<Definition>()>;
+};
+
+template<>
+struct DefinitionUnit<const WearLevelLongLong>
+{
+	template<const StorageAddress address, typename Definition>
+	using Type = LongLongWearLevelUnit<address, Definition::Size, Definition::WearLevelOption, Definition::Key, StorageParameter::GetErrorCorrection<Definition>()>;
+};
+
+/// <summary>
+/// Key indexed dispatch over a TemplateStorageAttributor layout.
+/// Emits a PROGMEM table of StorageEntry, sorted by Key, at compile time.
+/// Find(key) is a binary search over the table, with no RAM cost.
+/// Same assumptions as TemplateStorageAttributor, plus unique Keys.
+/// </summary>
+/// <typeparam name="...StorageTypes"></typeparam>
+template<typename... StorageTypes>
+class TemplateStorageDispatcher
+{
+private:
+	static_assert(StorageParameter::UniqueKeys<StorageTypes...>(), "Storage Keys must be unique.");
+
+	using Attributor = TemplateStorageAttributor<StorageTypes...>;
+
+	static constexpr size_t Count = sizeof...(StorageTypes);
+
+	template<const size_t Index>
+	struct UnitAccess
+	{
+		using Definition = typename TypeAt<Index, StorageTypes...>::Type;
+		using UnitType = typename DefinitionUnit<decltype(Definition::WearLevelOption)>::template Type<Attributor::GetAddress(Index), Definition>;
+
+		static UnitType& GetUnit()
+		{
+			static UnitType Unit{};
+
+			return Unit;
+		}
+
+		static const bool Begin()
+		{
+			GetUnit().Begin();
+
+			return true;
+		}
+
+		static const bool Read(uint8_t* target)
+		{
+			return GetUnit().ReadData(target);
+		}
+
+		static void Write(const uint8_t* source)
+		{
+			GetUnit().WriteData(source);
+		}
+
+		static constexpr StorageEntry GetEntry()
+		{
+			return StorageEntry{ Definition::Key, Attributor::GetAddress(Index), Definition::Size, (uint8_t)Definition::WearLevelOption, Read, Write };
+		}
+	};
+
+	template<typename Sequence>
+	struct Table;
+
+	template<size_t... Ranks>
+	struct Table<IndexSequence<Ranks...>>
+	{
+		static const StorageEntry Entries[sizeof...(Ranks)];
+	};
+
+	using SortedTable = Table<typename MakeIndexSequence<Count>::Type>;
+
+	/// <summary>
+	/// Stored layout fingerprint, right after the layout.
+	/// </summary>
+	using FingerprintUnit = StorageUnit<Attributor::GetUsed(), sizeof(uint32_t)>;
+
+	template<size_t... Indexes>
+	static void BeginUnits(IndexSequence<Indexes...>)
+	{
+		const bool begun[] = { UnitAccess<Indexes>::Begin()... };
+		(void)begun;
+	}
+
+public:
+	static constexpr size_t GetCount()
+	{
+		return Count;
+	}
+
+	/// <summary>
+	/// Layout size, plus the stored fingerprint used by Begin().
+	/// </summary>
+	static constexpr StorageAddress GetUsed()
+	{
+		return FingerprintUnit::Address() + FingerprintUnit::Size();
+	}
+
+	/// <summary>
+	/// Initializes all units in one sequential pass, call once from setup().
+	/// If the stored layout fingerprint matches, per-unit validation is skipped.
+	/// Otherwise, every unit is validated and the new fingerprint is stored.
+	/// </summary>
+	/// <returns>True if the stored layout matched and validation was skipped.</returns>
+	static const bool Begin()
+	{
+		FingerprintUnit fingerprintUnit{};
+		uint32_t fingerprint = 0;
+
+		fingerprintUnit.Begin();
+		if (fingerprintUnit.ReadData((uint8_t*)&fingerprint)
+			&& fingerprint == Attributor::GetFingerprint())
+		{
+			return true;
+		}
+
+		BeginUnits(typename MakeIndexSequence<Count>::Type());
+
+		fingerprint = Attributor::GetFingerprint();
+		fingerprintUnit.WriteData((const uint8_t*)&fingerprint);
+
+		return false;
+	}
+
+	/// <summary>
+	/// Binary search for the entry with key.
+	/// </summary>
+	/// <param name="key">Storage Key.</param>
+	/// <param name="entry">Entry copied from PROGMEM, if found.</param>
+	/// <returns>True if key was found.</returns>
+	static const bool Find(const uint32_t key, StorageEntry& entry)
+	{
+		size_t low = 0;
+		size_t high = Count;
+
+		while (low < high)
+		{
+			const size_t middle = low + ((high - low) / 2);
+			const uint32_t middleKey = pgm_read_dword(&SortedTable::Entries[middle].Key);
+
+			if (middleKey < key)
+			{
+				low = middle + 1;
+			}
+			else if (middleKey > key)
+			{
+				high = middle;
+			}
+			else
+			{
+				memcpy_P(&entry, &SortedTable::Entries[middle], sizeof(StorageEntry));
+
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/// <summary>
+	/// Reads the storage unit with key into target array.
+	/// </summary>
+	/// <param name="key">Storage Key.</param>
+	/// <param name="target">Target array, with the entry's Size.</param>
+	/// <returns>True if key was found and CRC matches.</returns>
+	static const bool ReadByKey(const uint32_t key, uint8_t* target)
+	{
+		StorageEntry entry;
+
+		return Find(key, entry) && entry.Read(target);
+	}
+
+	/// <summary>
+	/// Writes the storage unit with key from source array.
+	/// </summary>
+	/// <param name="key">Storage Key.</param>
+	/// <param name="source">Source array, with the entry's Size.</param>
+	/// <returns>True if key was found.</returns>
+	static const bool WriteByKey(const uint32_t key, const uint8_t* source)
+	{
+		StorageEntry entry;
+
+		if (Find(key, entry))
+		{
+			entry.Write(source);
+
+			return true;
+		}
+
+		return false;
+	}
+};
+
+template<typename... StorageTypes>
+template<size_t... Ranks>
+const StorageEntry TemplateStorageDispatcher<StorageTypes...>::Table<IndexSequence<Ranks...>>::Entries[sizeof...(Ranks)] PROGMEM =
+{
+	UnitAccess<StorageParameter::IndexByRank<StorageTypes...>(Ranks)>::GetEntry()...
+};
+#endif
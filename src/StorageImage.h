@@ -0,0 +1,229 @@
+#ifndef _STORAGE_IMAGE_h
+#define _STORAGE_IMAGE_h
+
+#include <Arduino.h>
+#include "EmbeddedStorageBase\EmbeddedEEPROM.h"
+#include <EmbeddedStorage.h>
+
+/// <summary>
+/// Import result.
+/// </summary>
+enum class ImageResult : uint8_t
+{
+	Success,
+	Timeout,
+	InvalidHeader,
+	LayoutMismatch,
+	ChecksumMismatch
+};
+
+/// <summary>
+/// Streaming bulk backup and restore of a TemplateStorageAttributor layout.
+/// The raw layout is streamed in address order, no unit CRCs are recalculated.
+/// ||Magic|Fingerprint|Size|Checksum||Chunk|Chunk Checksum||...||
+/// Size is sizeof(StorageAddress) bytes.
+/// Each chunk of up to ChunkSize data bytes is followed by its own checksum,
+///  Import verifies it before programming the chunk, so a corrupted stream never reaches EEPROM.
+/// Import only programs the bytes that differ.
+/// An interrupted Import is resumed by importing the same image again:
+///  bytes already programmed match and are skipped.
+/// </summary>
+/// <typeparam name="AttributorType">TemplateStorageAttributor.</typeparam>
+/// <param name="address">Layout start address in EEPROM.</param>
+template<typename AttributorType,
+	const StorageAddress address = 0>
+class StorageImage
+{
+private:
+	static constexpr uint16_t Magic = 0x5345; // 'ES'
+	static constexpr uint8_t SizeOffset = sizeof(uint16_t) + sizeof(uint32_t);
+	static constexpr uint8_t ChecksumOffset = SizeOffset + sizeof(StorageAddress);
+	static constexpr uint8_t HeaderSize = ChecksumOffset + sizeof(uint16_t);
+	static constexpr uint8_t ChunkSize = 32;
+
+	static_assert(EmbeddedStorage::Fits(AttributorType::GetUsed(), ChunkSize), "Layout must leave ChunkSize addresses of StorageAddress range.");
+
+	/// <summary>
+	/// Fletcher-16 whole image and chunk checksum.
+	/// </summary>
+	struct Fletcher16
+	{
+		uint16_t Sum1 = 0;
+		uint16_t Sum2 = 0;
+
+		void Add(const uint8_t value)
+		{
+			Sum1 += value;
+			Sum1 = (Sum1 & UINT8_MAX) + (Sum1 >> 8);
+			Sum2 += Sum1;
+			Sum2 = (Sum2 & UINT8_MAX) + (Sum2 >> 8);
+		}
+
+		const uint16_t Get() const
+		{
+			return ((Sum2 % UINT8_MAX) << 8) | (Sum1 % UINT8_MAX);
+		}
+	};
+
+public:
+	static constexpr StorageAddress GetImageSize()
+	{
+		return HeaderSize + AttributorType::GetUsed()
+			+ (((AttributorType::GetUsed() + ChunkSize - 1) / ChunkSize) * sizeof(uint16_t));
+	}
+
+	/// <summary>
+	/// Streams the header and the raw layout bytes, each chunk followed by its checksum.
+	/// </summary>
+	/// <param name="stream">Output stream.</param>
+	static void Export(Stream& stream)
+	{
+		const StorageAddress size = AttributorType::GetUsed();
+
+		Fletcher16 checksum{};
+		for (StorageAddress i = 0; i < size; i++)
+		{
+			checksum.Add(EmbeddedEEPROM::ReadBlock(address + i));
+		}
+
+		uint8_t buffer[ChunkSize + sizeof(uint16_t)];
+		WriteHeader(buffer, checksum.Get());
+		stream.write(buffer, HeaderSize);
+
+		for (StorageAddress i = 0; i < size; i += ChunkSize)
+		{
+			const uint8_t length = GetChunkLength(i, size);
+			Fletcher16 chunkChecksum{};
+			for (uint8_t j = 0; j < length; j++)
+			{
+				buffer[j] = EmbeddedEEPROM::ReadBlock(address + i + j);
+				chunkChecksum.Add(buffer[j]);
+			}
+			buffer[length] = chunkChecksum.Get() & UINT8_MAX;
+			buffer[length + 1] = chunkChecksum.Get() >> 8;
+			stream.write(buffer, length + sizeof(uint16_t));
+		}
+	}
+
+	/// <summary>
+	/// Validates the header and programs the differing layout bytes, one verified chunk at a time.
+	/// A chunk whose checksum mismatches is not programmed, the import stops there.
+	/// Uses the stream's timeout.
+	/// </summary>
+	/// <param name="stream">Input stream.</param>
+	/// <returns>ImageResult::Success if the image was fully imported and the checksums match.</returns>
+	static const ImageResult Import(Stream& stream)
+	{
+		const StorageAddress size = AttributorType::GetUsed();
+
+		uint8_t buffer[ChunkSize + sizeof(uint16_t)];
+		if (stream.readBytes(buffer, HeaderSize) != HeaderSize)
+		{
+			return ImageResult::Timeout;
+		}
+
+		if (GetUInt16(buffer, 0) != Magic
+			|| GetSize(buffer) != size)
+		{
+			return ImageResult::InvalidHeader;
+		}
+
+		if (GetUInt32(buffer, 2) != AttributorType::GetFingerprint())
+		{
+			return ImageResult::LayoutMismatch;
+		}
+
+		const uint16_t expectedChecksum = GetUInt16(buffer, ChecksumOffset);
+
+		Fletcher16 checksum{};
+		for (StorageAddress i = 0; i < size; i += ChunkSize)
+		{
+			const uint8_t length = GetChunkLength(i, size);
+			if (stream.readBytes(buffer, length + sizeof(uint16_t)) != (length + sizeof(uint16_t)))
+			{
+				return ImageResult::Timeout;
+			}
+
+			Fletcher16 chunkChecksum{};
+			for (uint8_t j = 0; j < length; j++)
+			{
+				chunkChecksum.Add(buffer[j]);
+			}
+
+			if (chunkChecksum.Get() != GetUInt16(buffer, length))
+			{
+				return ImageResult::ChecksumMismatch;
+			}
+
+			for (uint8_t j = 0; j < length; j++)
+			{
+				checksum.Add(buffer[j]);
+				if (EmbeddedEEPROM::ReadBlock(address + i + j) != buffer[j])
+				{
+					EmbeddedEEPROM::WriteBlock(address + i + j, buffer[j]);
+				}
+			}
+		}
+
+		if (checksum.Get() != expectedChecksum)
+		{
+			return ImageResult::ChecksumMismatch;
+		}
+
+		return ImageResult::Success;
+	}
+
+private:
+	static void WriteHeader(uint8_t* buffer, const uint16_t checksum)
+	{
+		const uint32_t fingerprint = AttributorType::GetFingerprint();
+		const StorageAddress size = AttributorType::GetUsed();
+
+		buffer[0] = Magic & UINT8_MAX;
+		buffer[1] = Magic >> 8;
+		buffer[2] = fingerprint & UINT8_MAX;
+		buffer[3] = (fingerprint >> 8) & UINT8_MAX;
+		buffer[4] = (fingerprint >> 16) & UINT8_MAX;
+		buffer[5] = fingerprint >> 24;
+		for (uint8_t i = 0; i < sizeof(StorageAddress); i++)
+		{
+			buffer[SizeOffset + i] = (size >> (i * 8)) & UINT8_MAX;
+		}
+		buffer[ChecksumOffset] = checksum & UINT8_MAX;
+		buffer[ChecksumOffset + 1] = checksum >> 8;
+	}
+
+	static const uint8_t GetChunkLength(const StorageAddress offset, const StorageAddress size)
+	{
+		if ((size - offset) < ChunkSize)
+		{
+			return size - offset;
+		}
+		else
+		{
+			return ChunkSize;
+		}
+	}
+
+	static const StorageAddress GetSize(const uint8_t* buffer)
+	{
+		StorageAddress size = 0;
+		for (uint8_t i = 0; i < sizeof(StorageAddress); i++)
+		{
+			size |= (StorageAddress)buffer[SizeOffset + i] << (i * 8);
+		}
+
+		return size;
+	}
+
+	static const uint16_t GetUInt16(const uint8_t* buffer, const uint8_t offset)
+	{
+		return ((uint16_t)buffer[offset + 1] << 8) | buffer[offset];
+	}
+
+	static const uint32_t GetUInt32(const uint8_t* buffer, const uint8_t offset)
+	{
+		return ((uint32_t)GetUInt16(buffer, offset + 2) << 16) | GetUInt16(buffer, offset);
+	}
+};
+#endif
@@ -0,0 +1,136 @@
+#ifndef _STORAGE_PLANNER_h
+#define _STORAGE_PLANNER_h
+
+#include <stdint.h>
+#include "StorageDispatcher.h"
+#include "EmbeddedStorageBase\EmbeddedDeviceProfile.h"
+
+/// <summary>
+/// Compile-time endurance planner, over a device profile's traits.
+/// Picks the number of wear levels needed for an expected write rate and lifetime.
+/// Every write wears the current slot and, on rollover, the counter.
+/// Page granular devices (EraseGranularity > 1) rewrite the counter's page on every increment,
+///  so wear leveling does not extend their lifetime.
+/// </summary>
+/// <typeparam name="DeviceProfile">Device traits, i.e. DeviceProfileATmega328P.</typeparam>
+template<typename DeviceProfile>
+class StoragePlanner
+{
+public:
+	/// <summary>
+	/// Returned by GetLevels() when no wear level option covers the budget.
+	/// </summary>
+	static constexpr uint32_t Unplannable = UINT32_MAX;
+
+	static constexpr uint64_t GetTotalWrites(const uint32_t writesPerDay, const uint16_t lifetimeDays)
+	{
+		return (uint64_t)writesPerDay * lifetimeDays;
+	}
+
+	/// <summary>
+	/// Wear levels needed for the write budget.
+	/// </summary>
+	/// <param name="writesPerDay">Expected unit writes per day.</param>
+	/// <param name="lifetimeDays">Target lifetime, in days.</param>
+	/// <returns>1 for StorageUnit, Unplannable if the budget exceeds WearLevelLongLong::x65.</returns>
+	static constexpr uint32_t GetLevels(const uint32_t writesPerDay, const uint16_t lifetimeDays)
+	{
+		return (GetTotalWrites(writesPerDay, lifetimeDays) <= DeviceProfile::EnduranceCycles) ? (uint32_t)NoWearLevel::x1
+			: (DeviceProfile::EraseGranularity > 1) ? Unplannable
+			: (GetTotalWrites(writesPerDay, lifetimeDays) > ((uint64_t)DeviceProfile::EnduranceCycles * (uint8_t)WearLevelLongLong::x65)) ? Unplannable
+			: (uint32_t)((GetTotalWrites(writesPerDay, lifetimeDays) + DeviceProfile::EnduranceCycles - 1) / DeviceProfile::EnduranceCycles);
+	}
+
+	static constexpr bool IsPlannable(const uint32_t writesPerDay, const uint16_t lifetimeDays)
+	{
+		return GetLevels(writesPerDay, lifetimeDays) != Unplannable;
+	}
+
+	/// <summary>
+	/// Expected lifetime of a unit with the given levels.
+	/// </summary>
+	/// <param name="writesPerDay">Expected unit writes per day.</param>
+	/// <param name="levels">Wear level option.</param>
+	/// <returns>Lifetime in days, saturated to UINT32_MAX.</returns>
+	static constexpr uint32_t GetLifetimeDays(const uint32_t writesPerDay, const uint8_t levels)
+	{
+		return (writesPerDay == 0) ? UINT32_MAX
+			: (((uint64_t)DeviceProfile::EnduranceCycles * ((DeviceProfile::EraseGranularity > 1) ? 1 : levels) / writesPerDay) > UINT32_MAX) ? UINT32_MAX
+			: (uint32_t)((uint64_t)DeviceProfile::EnduranceCycles * ((DeviceProfile::EraseGranularity > 1) ? 1 : levels) / writesPerDay);
+	}
+};
+
+/// <summary>
+/// Smallest wear level option type for Levels.
+/// </summary>
+template<const uint32_t Levels,
+	const uint8_t Category = (Levels <= (uint8_t)NoWearLevel::x1) ? 0
+	: (Levels <= (uint8_t)WearLevelTiny::x9) ? 1
+	: (Levels <= (uint8_t)WearLevelShort::x17) ? 2
+	: (Levels <= (uint8_t)WearLevelLong::x33) ? 3 : 4>
+struct PlannedWearLevel
+{
+	using Type = WearLevelLongLong;
+};
+
+template<const uint32_t Levels>
+struct PlannedWearLevel<Levels, 0>
+{
+	using Type = NoWearLevel;
+};
+
+template<const uint32_t Levels>
+struct PlannedWearLevel<Levels, 1>
+{
+	using Type = WearLevelTiny;
+};
+
+template<const uint32_t Levels>
+struct PlannedWearLevel<Levels, 2>
+{
+	using Type = WearLevelShort;
+};
+
+template<const uint32_t Levels>
+struct PlannedWearLevel<Levels, 3>
+{
+	using Type = WearLevelLong;
+};
+
+/// <summary>
+/// Storage definition with the WearLevelOption picked by StoragePlanner.
+/// Usable as a TemplateStorageAttributor/TemplateStorageDispatcher definition.
+/// Fails to compile if no wear level option covers the budget.
+/// </summary>
+/// <typeparam name="DeviceProfile">Device traits, i.e. DeviceProfileATmega328P.</typeparam>
+/// <typeparam name="DataType">Stored struct.</typeparam>
+/// <typeparam name="key">Storage Key.</typeparam>
+/// <typeparam name="writesPerDay">Expected unit writes per day.</typeparam>
+/// <typeparam name="lifetimeDays">Target lifetime, in days.</typeparam>
+/// <typeparam name="errorCorrection">Optional error correction.</typeparam>
+template<typename DeviceProfile,
+	typename DataType,
+	const uint32_t key,
+	const uint32_t writesPerDay,
+	const uint16_t lifetimeDays,
+	const ErrorCorrection errorCorrection = ErrorCorrection::None>
+struct PlannedDefinition
+{
+	using Struct = DataType;
+
+	static constexpr uint16_t Size = sizeof(DataType);
+	static constexpr uint32_t Key = key;
+	static constexpr uint32_t Levels = StoragePlanner<DeviceProfile>::GetLevels(writesPerDay, lifetimeDays);
+
+	static_assert(Levels != StoragePlanner<DeviceProfile>::Unplannable, "Write budget exceeds the device endurance, lower the write rate or lifetime.");
+
+	static constexpr typename PlannedWearLevel<Levels>::Type WearLevelOption = (typename PlannedWearLevel<Levels>::Type)Levels;
+	static constexpr ErrorCorrection ErrorCorrectionOption = errorCorrection;
+
+	/// <summary>
+	/// StorageUnit or WearLevelUnit type, at address.
+	/// </summary>
+	template<const StorageAddress address>
+	using Unit = typename DefinitionUnit<decltype(WearLevelOption)>::template Type<address, PlannedDefinition>;
+};
+#endif
@@ -0,0 +1,243 @@
+#ifndef _STORAGE_SCRUBBER_
+#define _STORAGE_SCRUBBER_
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "StorageAttributor.h"
+#include "EmbeddedStorageBase\EmbeddedEEPROM.h"
+#include "EmbeddedStorageBase\StorageEngine.h"
+
+// Scrub budget clock, in microseconds.
+// Defaults to the simulated clock with EEPROM_MOCK_IN_MEMORY, for deterministic budgets.
+#if !defined(EEPROM_SCRUB_CLOCK)
+#if defined(EEPROM_MOCK_IN_MEMORY)
+#define EEPROM_SCRUB_CLOCK() EmbeddedEEPROM::MockClock().ElapsedMicros
+#else
+#define EEPROM_SCRUB_CLOCK() micros()
+#endif
+#endif
+
+/// <summary>
+/// Run-time description of a scrubbed unit's current slot, as stored in PROGMEM.
+/// </summary>
+struct ScrubEntry
+{
+	uint32_t Key;
+	StorageAddress Address;
+	StorageAddress SlotSize;
+	uint16_t DataSize;
+	uint8_t WearLevelOption;
+	uint8_t CounterSize;
+};
+
+/// <summary>
+/// Time-sliced background CRC scrubber over a TemplateStorageAttributor layout.
+/// Step() verifies the current slot of the next unit, byte by byte, until its microsecond budget is spent.
+/// The cursor is kept across calls, a large unit is verified over several calls.
+/// The CRC is streamed straight from EEPROM, there is no buffer the size of a unit.
+/// A mismatch is verified once more before being reported, so a write between steps isn't reported.
+/// Never written units are reported as invalid too.
+/// Repair is left to the error callback, i.e. ReadVersion() of a wear level unit, or defaults.
+/// </summary>
+/// <typeparam name="...StorageTypes">Same definitions, in the same order, as the layout's attributor.</typeparam>
+template<typename... StorageTypes>
+class TemplateStorageScrubber
+{
+private:
+	using Attributor = TemplateStorageAttributor<StorageTypes...>;
+
+	static constexpr uint16_t Count = sizeof...(StorageTypes);
+
+	template<const size_t Index>
+	static constexpr ScrubEntry GetEntry()
+	{
+		using Definition = typename TypeAt<Index, StorageTypes...>::Type;
+
+		return ScrubEntry{ Definition::Key, Attributor::GetAddress(Index),
+			EmbeddedStorage::GetStorageSize(Definition::Size, NoWearLevel::x1, StorageParameter::GetErrorCorrection<Definition>()),
+			Definition::Size, (uint8_t)Definition::WearLevelOption,
+			(uint8_t)(((uint8_t)Definition::WearLevelOption > 1) ? EmbeddedStorage::GetWearLevelCounterSize((uint8_t)Definition::WearLevelOption) : 0) };
+	}
+
+	template<typename Sequence>
+	struct Table;
+
+	template<size_t... Indexes>
+	struct Table<IndexSequence<Indexes...>>
+	{
+		static const ScrubEntry Entries[sizeof...(Indexes)];
+	};
+
+	using EntryTable = Table<typename MakeIndexSequence<Count>::Type>;
+
+private:
+	void (*OnError)(const uint32_t key, const StorageAddress address);
+
+	ScrubEntry Entry{};
+	KeyedCrc Crc{};
+	StorageAddress SlotAddress = 0;
+	uint16_t UnitIndex = 0;
+	uint16_t Offset = 0;
+	uint16_t Errors = 0;
+	uint16_t Passes = 0;
+	uint8_t Counter = 0;
+	bool Started = false;
+	bool Suspect = false;
+
+public:
+	/// <summary>
+	/// Construction has no side effects.
+	/// </summary>
+	/// <param name="onError">Optional callback, with the invalid unit's Key and address.</param>
+	TemplateStorageScrubber(void (*onError)(const uint32_t key, const StorageAddress address) = nullptr)
+		: OnError(onError)
+	{}
+
+	static constexpr uint16_t GetCount()
+	{
+		return Count;
+	}
+
+	/// <summary>
+	/// Scrubs for up to budgetMicros, as measured by EEPROM_SCRUB_CLOCK().
+	/// The budget is checked before each EEPROM read, it is exceeded by at most one read,
+	///  or a wear level counter's reads when a unit starts.
+	/// </summary>
+	/// <param name="budgetMicros">Time budget, in microseconds.</param>
+	/// <returns>True if a full pass over all units completed during this call.</returns>
+	const bool Step(const uint32_t budgetMicros)
+	{
+		const uint32_t start = EEPROM_SCRUB_CLOCK();
+		bool completed = false;
+
+		while ((uint32_t)(EEPROM_SCRUB_CLOCK() - start) < budgetMicros)
+		{
+			if (!Started)
+			{
+				completed |= StartUnit();
+			}
+			else if (Offset < Entry.DataSize)
+			{
+				Crc.Add(EmbeddedEEPROM::ReadBlock(SlotAddress + Offset));
+				Offset++;
+			}
+			else
+			{
+				completed |= FinishUnit();
+			}
+		}
+
+		return completed;
+	}
+
+	/// <summary>
+	/// Number of invalid units found, since construction.
+	/// </summary>
+	const uint16_t GetErrorCount() const
+	{
+		return Errors;
+	}
+
+	/// <summary>
+	/// Number of completed passes over all units, since construction.
+	/// </summary>
+	const uint16_t GetPassCount() const
+	{
+		return Passes;
+	}
+
+private:
+	/// <summary>
+	/// Loads the unit's entry and finds its current slot.
+	/// </summary>
+	/// <returns>True if the unit's counter was invalid and it completed a pass.</returns>
+	const bool StartUnit()
+	{
+		memcpy_P(&Entry, &EntryTable::Entries[UnitIndex], sizeof(ScrubEntry));
+
+		Counter = 0;
+		if (Entry.CounterSize > 0)
+		{
+			if (!StorageEngine::ValidateCounter(Entry.Address, Entry.CounterSize))
+			{
+				Report();
+
+				return NextUnit();
+			}
+			Counter = StorageEngine::GetCounter(Entry.Address, Entry.CounterSize, Entry.WearLevelOption);
+		}
+
+		SlotAddress = Entry.Address + Entry.CounterSize + ((StorageAddress)Counter * Entry.SlotSize);
+		Offset = 0;
+		Crc.Start();
+		Started = true;
+
+		return false;
+	}
+
+	/// <summary>
+	/// Checks the unit's CRC.
+	/// A slot committed since the start, or a first mismatch, restarts the unit.
+	/// </summary>
+	/// <returns>True if the unit completed a pass.</returns>
+	const bool FinishUnit()
+	{
+		const bool valid = Crc.Finish(Entry.Key, Counter) == EmbeddedEEPROM::ReadBlock(SlotAddress + Entry.DataSize);
+
+		Started = false;
+
+		if (Entry.CounterSize > 0
+			&& StorageEngine::GetCounter(Entry.Address, Entry.CounterSize, Entry.WearLevelOption) != Counter)
+		{
+			return false;
+		}
+
+		if (!valid && !Suspect)
+		{
+			Suspect = true;
+
+			return false;
+		}
+
+		if (!valid)
+		{
+			Report();
+		}
+
+		return NextUnit();
+	}
+
+	void Report()
+	{
+		Errors++;
+		if (OnError != nullptr)
+		{
+			OnError(Entry.Key, Entry.Address);
+		}
+	}
+
+	const bool NextUnit()
+	{
+		Started = false;
+		Suspect = false;
+		UnitIndex++;
+
+		if (UnitIndex >= Count)
+		{
+			UnitIndex = 0;
+			Passes++;
+
+			return true;
+		}
+
+		return false;
+	}
+};
+
+template<typename... StorageTypes>
+template<size_t... Indexes>
+const ScrubEntry TemplateStorageScrubber<StorageTypes...>::Table<IndexSequence<Indexes...>>::Entries[sizeof...(Indexes)] PROGMEM =
+{
+	TemplateStorageScrubber<StorageTypes...>::template GetEntry<Indexes>()...
+};
+#endif
@@ -2,37 +2,52 @@
 #define _STORAGE_UNIT_
 
 #include "EmbeddedStorageBase\EmbeddedEEPROM.h"
-#include "EmbeddedStorageBase\EmbeddedCrc.h"
+#include "EmbeddedStorageBase\StorageEngine.h"
 #include <EmbeddedStorage.h>
 
 /// <summary>
 /// CRC checked EEPROM storage unit.
 /// Designed for use with a single data struct or array.
+/// Typed facade over the shared StorageEngine.
 /// </summary>
 /// <param name="DataSize">Data size in bytes.</param>
 /// <param name="Key">Storage cryptographic salt key.
 ///  Changing the key invalidates any previous data.</param>
-template<const uint16_t address,
+/// <param name="Correction">Optional error correction, on CRC mismatch.</param>
+template<const StorageAddress address,
 	const uint16_t DataSize,
-	const uint32_t Key = DataSize>
+	const uint32_t Key = DataSize,
+	const ErrorCorrection Correction = ErrorCorrection::None>
 class StorageUnit
 {
 private:
-	EmbeddedCrc<Key> Crc{};
+	static_assert(EmbeddedStorage::Fits(address, EmbeddedStorage::GetStorageSpan(DataSize, NoWearLevel::x1, Correction)), "Unit exceeds the StorageAddress range, enable EEPROM_ADDRESS_32.");
 
 public:
-	static constexpr uint16_t Address()
+	static constexpr StorageAddress Address()
 	{
 		return address;
 	}
 
-	static constexpr uint16_t Size()
+	static constexpr StorageAddress Size()
 	{
-		return EmbeddedStorage::GetStorageSize(DataSize);
+		return EmbeddedStorage::GetStorageSize(DataSize, NoWearLevel::x1, Correction);
+	}
+
+	/// <summary>
+	/// Declared data size in bytes, for wrappers.
+	/// </summary>
+	static constexpr uint16_t GetDataSize()
+	{
+		return DataSize;
 	}
 
 public:
-	StorageUnit()
+	/// <summary>
+	/// Prepares the EEPROM backend.
+	/// Construction has no side effects, call once from setup().
+	/// </summary>
+	void Begin()
 	{
 		EEPROM.begin();
 	}
@@ -44,12 +59,43 @@ public:
 	/// <returns>True if CRC matches.</returns>
 	const bool ReadData(uint8_t* target)
 	{
-		for (uint16_t i = 0; i < DataSize; i++)
-		{
-			target[i] = EmbeddedEEPROM::ReadBlock(address + i);
-		}
+		uint8_t corrections = 0;
+
+		return ReadData(target, corrections);
+	}
+
+	/// <summary>
+	/// Reads the declared DataSize into target array.
+	/// With error correction, single bit errors are corrected on CRC mismatch.
+	/// </summary>
+	/// <param name="target">Target array.</param>
+	/// <param name="corrections">Number of corrected blocks.</param>
+	/// <returns>True if CRC matches, after any correction.</returns>
+	const bool ReadData(uint8_t* target, uint8_t& corrections)
+	{
+		corrections = 0;
+
+		return StorageEngine::ReadSlot(address, target, DataSize, Key, 0)
+			|| (Correction == ErrorCorrection::Secded
+				&& StorageEngine::CorrectSlot(address, target, DataSize, Key, 0, corrections));
+	}
 
-		return Crc.GetCrc(target, DataSize) == EmbeddedEEPROM::ReadBlock(address + DataSize);
+	/// <summary>
+	/// Validates the stored data's CRC, with no RAM buffer.
+	/// </summary>
+	/// <returns>True if CRC matches.</returns>
+	const bool Verify()
+	{
+		return StorageEngine::VerifySlot(address, DataSize, Key, 0);
+	}
+
+	/// <summary>
+	/// Invalidates the stored data, writing only the CRC byte.
+	/// i.e. a factory reset, with defaults from DefaultedUnit.
+	/// </summary>
+	void Invalidate()
+	{
+		StorageEngine::InvalidateSlot(address, DataSize, Key, 0);
 	}
 
 	/// <summary>
@@ -58,20 +104,20 @@ public:
 	/// <param name="source">Source array.</param>
 	void WriteData(const uint8_t* source)
 	{
-		for (uint16_t i = 0; i < DataSize; i++)
+		const uint8_t crc = StorageEngine::WriteSlot(address, source, DataSize, Key, 0);
+
+		if (Correction == ErrorCorrection::Secded)
 		{
-			EmbeddedEEPROM::WriteBlock(address + i, source[i]);
+			EmbeddedEcc::WriteParity(address, source, DataSize, crc);
 		}
-
-		EmbeddedEEPROM::WriteBlock(address + DataSize, Crc.GetCrc(source, DataSize));
 	}
 
-	void WriteByte(const uint16_t offset, const uint8_t value)
+	void WriteByte(const StorageAddress offset, const uint8_t value)
 	{
 		EmbeddedEEPROM::WriteBlock(address + offset, value);
 	}
 
-	const uint8_t ReadByte(const uint16_t offset)
+	const uint8_t ReadByte(const StorageAddress offset)
 	{
 		return EmbeddedEEPROM::ReadBlock(address + offset);
 	}
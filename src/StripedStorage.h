@@ -0,0 +1,328 @@
+#ifndef _STRIPED_STORAGE_
+#define _STRIPED_STORAGE_
+
+#include <stdint.h>
+#include <StorageAddressType.h>
+#include <EmbeddedStorage.h>
+#include "EmbeddedStorageBase\EmbeddedCrc.h"
+
+/// <summary>
+/// Non-blocking write scheduler over several external EEPROM devices.
+/// Each write cycle runs inside its chip, so independent chips can cycle concurrently.
+/// Writes are queued per device, Service() starts the next write on every idle device
+///  and moves on while the others are busy, polling instead of blocking.
+/// Queued bytes with consecutive addresses in the same page are written together, in a single page write cycle.
+/// Aggregate write throughput scales with the number of devices, until the bus is saturated.
+///
+/// DeviceType provides:
+///  - void Begin()
+///  - const bool IsBusy(), i.e. I2C ACK polling.
+///  - const uint8_t GetPageSize(), bytes per write cycle, page writes never cross a page boundary.
+///  - void StartWrite(const StorageAddress address, const uint8_t* data, const uint8_t length), returns once the cycle has started.
+///  - const uint8_t Read(const StorageAddress address), only called when not busy.
+/// See I2CEepromDevice and MockStripeDevice.
+/// </summary>
+/// <typeparam name="DeviceType">Device driver type.</typeparam>
+/// <param name="DeviceCount">Number of devices, from 1 to 8.</param>
+/// <param name="QueueSize">Pending byte writes per device, from 1 to 254.</param>
+template<typename DeviceType,
+	const uint8_t DeviceCount,
+	const uint8_t QueueSize = 16>
+class StripedWriteScheduler
+{
+private:
+	static_assert(DeviceCount > 0 && DeviceCount <= 8, "DeviceCount must be from 1 to 8.");
+	static_assert(QueueSize > 0 && QueueSize < UINT8_MAX, "QueueSize must be from 1 to 254.");
+
+	static constexpr uint8_t RingSize = QueueSize + 1;
+
+	struct PendingWrite
+	{
+		StorageAddress Address;
+		uint8_t Value;
+	};
+
+	struct DeviceQueue
+	{
+		PendingWrite Ring[RingSize];
+		uint8_t Head;
+		uint8_t Tail;
+	};
+
+private:
+	DeviceType* Devices[DeviceCount];
+	DeviceQueue Queues[DeviceCount]{};
+
+public:
+	/// <summary>
+	/// Construction has no side effects, call Begin() once from setup().
+	/// </summary>
+	/// <param name="devices">Device drivers, in device index order.</param>
+	StripedWriteScheduler(DeviceType* const (&devices)[DeviceCount])
+	{
+		for (uint8_t i = 0; i < DeviceCount; i++)
+		{
+			Devices[i] = devices[i];
+		}
+	}
+
+	static constexpr uint8_t GetDeviceCount()
+	{
+		return DeviceCount;
+	}
+
+	void Begin()
+	{
+		for (uint8_t i = 0; i < DeviceCount; i++)
+		{
+			Devices[i]->Begin();
+		}
+	}
+
+	/// <summary>
+	/// Queues a ||Data|CRC|| slot write, same format as StorageEngine::WriteSlot().
+	/// Only blocks while the device's queue is full, servicing every device meanwhile.
+	/// </summary>
+	/// <param name="device">Device index.</param>
+	/// <param name="slotAddress">Slot start address, in the device.</param>
+	/// <param name="source">Source array.</param>
+	/// <param name="dataSize">Data size in bytes.</param>
+	/// <param name="key">Storage cryptographic salt key.</param>
+	/// <param name="salt">CRC salt.</param>
+	/// <returns>Written CRC.</returns>
+	const uint8_t WriteSlot(const uint8_t device, const StorageAddress slotAddress, const uint8_t* source, const uint16_t dataSize,
+		const uint32_t key, const uint8_t salt)
+	{
+		KeyedCrc crc{};
+
+		for (uint16_t i = 0; i < dataSize; i++)
+		{
+			Enqueue(device, slotAddress + i, source[i]);
+		}
+
+		const uint8_t storedCrc = crc.GetCrc(source, dataSize, key, salt);
+		Enqueue(device, slotAddress + dataSize, storedCrc);
+
+		return storedCrc;
+	}
+
+	/// <summary>
+	/// Reads a ||Data|CRC|| slot into target array.
+	/// Pending writes to the device are completed first.
+	/// </summary>
+	/// <returns>True if CRC matches.</returns>
+	const bool ReadSlot(const uint8_t device, const StorageAddress slotAddress, uint8_t* target, const uint16_t dataSize,
+		const uint32_t key, const uint8_t salt)
+	{
+		KeyedCrc crc{};
+
+		Flush(device);
+
+		for (uint16_t i = 0; i < dataSize; i++)
+		{
+			target[i] = Devices[device]->Read(slotAddress + i);
+		}
+
+		return crc.GetCrc(target, dataSize, key, salt) == Devices[device]->Read(slotAddress + dataSize);
+	}
+
+	/// <summary>
+	/// Starts the next pending page write on every idle device.
+	/// Call from loop(), or let Flush() spin on it.
+	/// Unchanged bytes at either end of the page write are skipped, same as EEPROM.update().
+	/// </summary>
+	/// <returns>Number of write cycles started.</returns>
+	const uint8_t Service()
+	{
+		uint8_t started = 0;
+
+		for (uint8_t i = 0; i < DeviceCount; i++)
+		{
+			if (Queues[i].Head != Queues[i].Tail
+				&& !Devices[i]->IsBusy()
+				&& StartPageWrite(i))
+			{
+				started++;
+			}
+		}
+
+		return started;
+	}
+
+	/// <summary>
+	/// Services all devices until every queue is empty.
+	/// The last write cycles may still be running.
+	/// </summary>
+	void Flush()
+	{
+		while (!IsIdle())
+		{
+			Service();
+		}
+	}
+
+	/// <summary>
+	/// Services all devices until device's queue is empty and its last write cycle is complete.
+	/// </summary>
+	void Flush(const uint8_t device)
+	{
+		while (GetPendingCount(device) > 0)
+		{
+			Service();
+		}
+
+		while (Devices[device]->IsBusy());
+	}
+
+	const bool IsIdle() const
+	{
+		for (uint8_t i = 0; i < DeviceCount; i++)
+		{
+			if (GetPendingCount(i) > 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	const uint8_t GetPendingCount(const uint8_t device) const
+	{
+		const uint8_t head = Queues[device].Head;
+		const uint8_t tail = Queues[device].Tail;
+
+		if (head >= tail)
+		{
+			return head - tail;
+		}
+		else
+		{
+			return RingSize - tail + head;
+		}
+	}
+
+private:
+	/// <summary>
+	/// Dequeues the run of consecutive addresses at the queue's tail, up to the page boundary,
+	///  and writes it from its first to its last changed byte.
+	/// </summary>
+	/// <returns>True if a write cycle was started.</returns>
+	const bool StartPageWrite(const uint8_t device)
+	{
+		DeviceQueue& queue = Queues[device];
+		DeviceType& driver = *Devices[device];
+		const uint8_t pageSize = driver.GetPageSize();
+		const StorageAddress address = queue.Ring[queue.Tail].Address;
+		uint8_t data[QueueSize];
+		uint8_t length = 0;
+
+		do
+		{
+			data[length++] = queue.Ring[queue.Tail].Value;
+			queue.Tail = GetNextIndex(queue.Tail);
+		} while (queue.Head != queue.Tail
+			&& queue.Ring[queue.Tail].Address == (address + length)
+			&& ((address + length) % pageSize) != 0);
+
+		uint8_t first = 0;
+		while (first < length
+			&& driver.Read(address + first) == data[first])
+		{
+			first++;
+		}
+
+		if (first == length)
+		{
+			return false;
+		}
+
+		uint8_t last = length - 1;
+		while (last > first
+			&& driver.Read(address + last) == data[last])
+		{
+			last--;
+		}
+
+		driver.StartWrite(address + first, &data[first], last - first + 1);
+
+		return true;
+	}
+
+	void Enqueue(const uint8_t device, const StorageAddress address, const uint8_t value)
+	{
+		while (GetPendingCount(device) >= QueueSize)
+		{
+			Service();
+		}
+
+		DeviceQueue& queue = Queues[device];
+		queue.Ring[queue.Head] = PendingWrite{ address, value };
+		queue.Head = GetNextIndex(queue.Head);
+	}
+
+	static constexpr uint8_t GetNextIndex(const uint8_t index)
+	{
+		return (index + 1) % RingSize;
+	}
+};
+
+/// <summary>
+/// CRC checked storage unit, on one device of a StripedWriteScheduler.
+/// ||Data...|CRC||
+/// Address is in the device, each device can have its own TemplateStorageAttributor layout.
+/// WriteData() only queues the write, see StripedWriteScheduler::Service().
+/// </summary>
+/// <param name="device">Device index.</param>
+/// <param name="DataSize">Data size in bytes.</param>
+/// <param name="Key">Storage cryptographic salt key.
+///  Changing the key invalidates any previous data.</param>
+template<const uint8_t device,
+	const StorageAddress address,
+	const uint16_t DataSize,
+	const uint32_t Key = DataSize>
+class StripedStorageUnit
+{
+private:
+	static_assert(EmbeddedStorage::Fits(address, EmbeddedStorage::GetStorageSpan(DataSize, NoWearLevel::x1)), "Unit exceeds the StorageAddress range, enable EEPROM_ADDRESS_32.");
+
+public:
+	static constexpr uint8_t Device()
+	{
+		return device;
+	}
+
+	static constexpr StorageAddress Address()
+	{
+		return address;
+	}
+
+	static constexpr StorageAddress Size()
+	{
+		return EmbeddedStorage::GetStorageSize(DataSize);
+	}
+
+public:
+	/// <summary>
+	/// Reads the declared DataSize into target array.
+	/// Pending writes to the device are completed first.
+	/// </summary>
+	/// <returns>True if CRC matches.</returns>
+	template<typename SchedulerType>
+	const bool ReadData(SchedulerType& scheduler, uint8_t* target)
+	{
+		return scheduler.ReadSlot(device, address, target, DataSize, Key, 0);
+	}
+
+	/// <summary>
+	/// Queues a write of the declared DataSize from source array.
+	/// </summary>
+	template<typename SchedulerType>
+	void WriteData(SchedulerType& scheduler, const uint8_t* source)
+	{
+		static_assert(device < SchedulerType::GetDeviceCount(), "Device index exceeds the scheduler's DeviceCount.");
+
+		scheduler.WriteSlot(device, address, source, DataSize, Key, 0);
+	}
+};
+#endif
@@ -3,6 +3,37 @@
 
 #include <stdint.h>
 #include "EmbeddedStorage.h"
+#include "EmbeddedStorageBase\EmbeddedHash.h"
+
+/// <summary>
+/// Compile-time index list, for expanding over variadic parameters.
+/// </summary>
+template<size_t... Indexes>
+struct IndexSequence {};
+
+template<size_t Count, size_t... Indexes>
+struct MakeIndexSequence : MakeIndexSequence<Count - 1, Count - 1, Indexes...> {};
+
+template<size_t... Indexes>
+struct MakeIndexSequence<0, Indexes...>
+{
+	using Type = IndexSequence<Indexes...>;
+};
+
+/// <summary>
+/// Type of the variadic parameter at Index.
+/// </summary>
+template<const size_t Index, typename First, typename... Parameters>
+struct TypeAt
+{
+	using Type = typename TypeAt<Index - 1, Parameters...>::Type;
+};
+
+template<typename First, typename... Parameters>
+struct TypeAt<0, First, Parameters...>
+{
+	using Type = First;
+};
 
 /// <summary>
 /// Recursive variadic template parameters helper.
@@ -70,89 +101,210 @@ public:
 	}
 
 	template<typename... Parameters>
-	static constexpr size_t Sum() {
+	static constexpr uint32_t Sum() {
 		return Sum<0, Parameters...>();
 	}
 
 	template<typename... Parameters>
-	static constexpr size_t Size(const size_t target) {
+	static constexpr uint32_t Size(const size_t target) {
 		return Size<0, Parameters...>(target);
 	}
 
 	template<typename... Parameters>
-	static constexpr size_t SizeByKey(const uint32_t key) {
+	static constexpr uint32_t SizeByKey(const uint32_t key) {
 		return SizeByKey<0, Parameters...>(key);
 	}
 
 	template<typename... Parameters>
-	static constexpr size_t SumUpTo(const size_t target) {
+	static constexpr uint32_t SumUpTo(const size_t target) {
 		return SumUpTo<0, Parameters...>(target);
 	}
 
 	template<typename... Parameters>
-	static constexpr size_t SumUpToKey(const uint32_t key) {
+	static constexpr uint32_t SumUpToKey(const uint32_t key) {
 		return SumUpToKey<0, Parameters...>(key, false);
 	}
 
+	/// <summary>
+	/// Sorted position of key, i.e. how many Parameters have a lower Key.
+	/// </summary>
+	template<typename... Parameters>
+	static constexpr size_t KeyRank(const uint32_t key) {
+		return KeyRank<0, Parameters...>(key);
+	}
+
+	/// <summary>
+	/// Index of the Parameter with the given sorted position.
+	/// </summary>
+	template<typename... Parameters>
+	static constexpr size_t IndexByRank(const size_t rank) {
+		return RankParameter<Parameters...>::template IndexByRank<0, Parameters...>(rank);
+	}
+
+	template<typename... Parameters>
+	static constexpr bool UniqueKeys() {
+		return UniqueKeys<0, Parameters...>();
+	}
+
+	/// <summary>
+	/// Optional ErrorCorrectionOption static property, ErrorCorrection::None if not declared.
+	/// </summary>
+	template<typename Definition>
+	static constexpr ErrorCorrection GetErrorCorrection() {
+		return ErrorCorrectionOf<Definition>(0);
+	}
+
+	/// <summary>
+	/// Hash of every Parameter's Key, Size, WearLevelOption and ErrorCorrectionOption, in order.
+	/// </summary>
+	template<typename... Parameters>
+	static constexpr uint32_t Fingerprint() {
+		return Fingerprint<0, Parameters...>(EmbeddedHash::Seed);
+	}
+
 private:
 	template<const size_t depth>
-	static constexpr size_t Sum() {
+	static constexpr uint32_t Sum() {
 		return 0;
 	}
 
 	template<const size_t depth, typename First, typename... Parameters>
-	static constexpr size_t Sum() {
-		return EmbeddedStorage::GetStorageSize(First::Size, First::WearLevelOption) + Sum<depth + 1, Parameters...>();
+	static constexpr uint32_t Sum() {
+		return EmbeddedStorage::GetStorageSpan(First::Size, First::WearLevelOption, GetErrorCorrection<First>()) + Sum<depth + 1, Parameters...>();
 	}
 
 private:
 	template<const size_t depth>
-	static constexpr size_t SumUpTo(const size_t target) {
+	static constexpr uint32_t SumUpTo(const size_t target) {
 		return 0;
 	}
 
 	template<const size_t depth,
 		typename First,
 		typename... Parameters>
-	static constexpr size_t SumUpTo(const size_t target) {
-		return (EmbeddedStorage::GetStorageSize(First::Size, First::WearLevelOption) * (target > depth)) + SumUpTo<depth + 1, Parameters...>(target);
+	static constexpr uint32_t SumUpTo(const size_t target) {
+		return (EmbeddedStorage::GetStorageSpan(First::Size, First::WearLevelOption, GetErrorCorrection<First>()) * (target > depth)) + SumUpTo<depth + 1, Parameters...>(target);
 	}
 
 	template<const size_t depth>
-	static constexpr size_t SumUpToKey(const uint32_t target, const bool found) {
+	static constexpr uint32_t SumUpToKey(const uint32_t target, const bool found) {
 		return 0;
 	}
 
 	template<const size_t depth,
 		typename First,
 		typename... Parameters>
-	static constexpr size_t SumUpToKey(const uint32_t key, const bool found) {
-		return (EmbeddedStorage::GetStorageSize(First::Size, First::WearLevelOption) * (!found && (key != First::Key))) + SumUpToKey<depth + 1, Parameters...>(key, found || (key == First::Key));
+	static constexpr uint32_t SumUpToKey(const uint32_t key, const bool found) {
+		return (EmbeddedStorage::GetStorageSpan(First::Size, First::WearLevelOption, GetErrorCorrection<First>()) * (!found && (key != First::Key))) + SumUpToKey<depth + 1, Parameters...>(key, found || (key == First::Key));
 	}
 
 private:
 	template<const size_t depth>
-	static constexpr size_t Size(const size_t target) {
+	static constexpr uint32_t Size(const size_t target) {
+		return 0;
+	}
+
+	template<const size_t depth,
+		typename First,
+		typename... Parameters>
+	static constexpr uint32_t Size(const size_t target) {
+		return (EmbeddedStorage::GetStorageSpan(First::Size, First::WearLevelOption, GetErrorCorrection<First>()) * (target == depth)) + Size<depth + 1, Parameters...>(target);
+	}
+
+	template<const size_t depth>
+	static constexpr uint32_t SizeByKey(const uint32_t key) {
 		return 0;
 	}
 
 	template<const size_t depth,
 		typename First,
 		typename... Parameters>
-	static constexpr size_t Size(const size_t target) {
-		return (EmbeddedStorage::GetStorageSize(First::Size, First::WearLevelOption) * (target == depth)) + Size<depth + 1, Parameters...>(target);
+	static constexpr uint32_t SizeByKey(const uint32_t key) {
+		return (EmbeddedStorage::GetStorageSpan(First::Size, First::WearLevelOption, GetErrorCorrection<First>()) * (key == First::Key)) + SizeByKey<depth + 1, Parameters...>(key);
 	}
 
+private:
 	template<const size_t depth>
-	static constexpr size_t SizeByKey(const uint32_t key) {
+	static constexpr size_t KeyRank(const uint32_t key) {
 		return 0;
 	}
 
 	template<const size_t depth,
 		typename First,
 		typename... Parameters>
-	static constexpr size_t SizeByKey(const uint32_t key) {
-		return (EmbeddedStorage::GetStorageSize(First::Size, First::WearLevelOption) * (key == First::Key)) + SizeByKey<depth + 1, Parameters...>(key);
+	static constexpr size_t KeyRank(const uint32_t key) {
+		return (First::Key < key) + KeyRank<depth + 1, Parameters...>(key);
+	}
+
+	/// <summary>
+	/// Keeps the full parameter list, for ranking while recursing.
+	/// </summary>
+	template<typename... AllParameters>
+	struct RankParameter
+	{
+		template<const size_t depth>
+		static constexpr size_t IndexByRank(const size_t rank) {
+			return 0;
+		}
+
+		template<const size_t depth,
+			typename First,
+			typename... Parameters>
+		static constexpr size_t IndexByRank(const size_t rank) {
+			return (depth * (KeyRank<AllParameters...>(First::Key) == rank)) + IndexByRank<depth + 1, Parameters...>(rank);
+		}
+	};
+
+	template<typename Definition>
+	static constexpr auto ErrorCorrectionOf(int) -> decltype((ErrorCorrection)Definition::ErrorCorrectionOption) {
+		return Definition::ErrorCorrectionOption;
+	}
+
+	template<typename Definition>
+	static constexpr ErrorCorrection ErrorCorrectionOf(long) {
+		return ErrorCorrection::None;
+	}
+
+	static constexpr uint32_t AddErrorCorrection(const uint32_t hash, const ErrorCorrection errorCorrection) {
+		return (errorCorrection == ErrorCorrection::None) ? hash : EmbeddedHash::Add(hash, (uint8_t)errorCorrection);
+	}
+
+	template<const size_t depth>
+	static constexpr uint32_t Fingerprint(const uint32_t hash) {
+		return hash;
+	}
+
+	template<const size_t depth,
+		typename First,
+		typename... Parameters>
+	static constexpr uint32_t Fingerprint(const uint32_t hash) {
+		return Fingerprint<depth + 1, Parameters...>(AddErrorCorrection(
+			EmbeddedHash::Add(EmbeddedHash::Add16(EmbeddedHash::Add32(hash, First::Key), First::Size), (uint8_t)First::WearLevelOption),
+			GetErrorCorrection<First>()));
+	}
+
+	template<const size_t depth>
+	static constexpr bool UniqueKeys() {
+		return true;
+	}
+
+	template<const size_t depth,
+		typename First,
+		typename... Parameters>
+	static constexpr bool UniqueKeys() {
+		return !ContainsKey<0, Parameters...>(First::Key) && UniqueKeys<depth + 1, Parameters...>();
+	}
+
+	template<const size_t depth>
+	static constexpr bool ContainsKey(const uint32_t key) {
+		return false;
+	}
+
+	template<const size_t depth,
+		typename First,
+		typename... Parameters>
+	static constexpr bool ContainsKey(const uint32_t key) {
+		return (key == First::Key) || ContainsKey<depth + 1, Parameters...>(key);
 	}
 };
 #endif
\ No newline at end of file
@@ -2,47 +2,57 @@
 #define _BASE_WEAR_LEVEL_UNIT_
 
 #include "EmbeddedStorageBase\EmbeddedEEPROM.h"
-#include "EmbeddedStorageBase\EmbeddedCrc.h"
+#include "EmbeddedStorageBase\StorageEngine.h"
 
 
 /// <summary>
 /// Base Wear levelled, CRC checked EEPROM storage unit.
 /// Flash overhead: 1 byte for counter, 1 byte for CRC times WearLevelOption.
 /// Designed for use with a single data struct or array.
+/// Typed facade over the shared StorageEngine, with a unary counter of GetCounterSize() bytes.
 /// </summary>
 /// <typeparam name="address">Address (offset) in EEPROM.</typeparam>
 /// <param name="DataSize">Data size in bytes.</param>
 /// <param name="WearLevelOption">WearLevel option, from 2 to 8.</param>
 /// <param name="Key">Storage cryptographic salt key.
 ///  Changing the key invalidates any previous data.</param>
-template<const uint16_t address,
+/// <param name="Correction">Optional error correction, on CRC mismatch.</param>
+template<const StorageAddress address,
 	const uint16_t DataSize,
 	const uint32_t Key,
 	typename WearLevelType,
-	const WearLevelType WearLevelOption>
+	const WearLevelType WearLevelOption,
+	const ErrorCorrection Correction = ErrorCorrection::None>
 class BaseWearLevelUnit
 {
 private:
-	EmbeddedCrc<Key> Crc{};
+	static_assert(EmbeddedStorage::Fits(address, EmbeddedStorage::GetStorageSpan(DataSize, WearLevelOption, Correction)), "Unit exceeds the StorageAddress range, enable EEPROM_ADDRESS_32.");
 
 public:
-	static constexpr uint16_t Address()
+	static constexpr StorageAddress Address()
 	{
 		return address;
 	}
 
-	static constexpr uint16_t Size()
+	static constexpr StorageAddress Size()
 	{
-		return EmbeddedStorage::GetStorageSize(DataSize, WearLevelOption);
+		return EmbeddedStorage::GetStorageSize(DataSize, WearLevelOption, Correction);
 	}
 
-protected:
-	virtual const uint8_t GetCurrentCounter() { return 0; }
-	virtual const uint8_t IncrementCounter() { return 0; }
-	virtual const bool ValidateCounterMask() { return false; }
+	/// <summary>
+	/// Declared data size in bytes, for wrappers.
+	/// </summary>
+	static constexpr uint16_t GetDataSize()
+	{
+		return DataSize;
+	}
 
 public:
-	BaseWearLevelUnit()
+	/// <summary>
+	/// Validates the counter, resetting it if invalid (i.e. first use or layout change).
+	/// Construction has no side effects, call once from setup().
+	/// </summary>
+	void Begin()
 	{
 		EEPROM.begin();
 		Initialize();
@@ -55,10 +65,7 @@ protected:
 #endif
 	void ResetCounter()
 	{
-		for (uint8_t i = 0; i < GetCounterSize(); i++)
-		{
-			EmbeddedEEPROM::ProgramZeroBitsToZero(address + i, 0);
-		}
+		StorageEngine::ResetCounter(address, GetCounterSize());
 	}
 
 public:
@@ -77,12 +84,12 @@ public:
 	{
 		Initialize();
 	}
+#endif
 
 	static constexpr size_t GetCounterSize()
 	{
 		return EmbeddedStorage::GetWearLevelCounterSize((uint8_t)WearLevelOption);
 	}
-#endif
 
 	/// <summary>
 	/// Reads the declared DataSize into target array.
@@ -90,62 +97,214 @@ public:
 	/// <param name="target">Target array.</param>
 	/// <returns>True if CRC matches.</returns>
 	const bool ReadData(uint8_t* target)
+	{
+		uint8_t corrections = 0;
+
+		return ReadData(target, corrections);
+	}
+
+	/// <summary>
+	/// Reads the declared DataSize into target array.
+	/// With error correction, single bit errors are corrected on CRC mismatch.
+	/// </summary>
+	/// <param name="target">Target array.</param>
+	/// <param name="corrections">Number of corrected blocks.</param>
+	/// <returns>True if CRC matches, after any correction.</returns>
+	const bool ReadData(uint8_t* target, uint8_t& corrections)
+	{
+		return ReadCounterSlot(GetCurrentCounter(), target, corrections);
+	}
+
+	/// <summary>
+	/// Validates the current slot's CRC, with no RAM buffer.
+	/// </summary>
+	/// <returns>True if CRC matches.</returns>
+	const bool Verify()
 	{
 		const uint8_t counter = GetCurrentCounter();
-		const uint16_t offset = (uint16_t)GetCounterSize() + ((uint16_t)counter * EmbeddedStorage::GetStorageSize(DataSize));
 
-		for (uint16_t i = 0; i < DataSize; i++)
+		return StorageEngine::VerifySlot(GetSlotAddress(counter), DataSize, Key, counter);
+	}
+
+	/// <summary>
+	/// Invalidates the current slot, writing only its CRC byte.
+	/// Older versions are kept, see ReadVersion().
+	/// </summary>
+	void Invalidate()
+	{
+		const uint8_t counter = GetCurrentCounter();
+
+		StorageEngine::InvalidateSlot(GetSlotAddress(counter), DataSize, Key, counter);
+	}
+
+	/// <summary>
+	/// Reads a previous version of the data, from the older slots.
+	/// Up to WearLevelOption versions are kept, with no extra writes.
+	/// </summary>
+	/// <param name="age">Version age, 0 for the current data, up to WearLevelOption - 1.</param>
+	/// <param name="target">Target array.</param>
+	/// <returns>True if the version is valid.</returns>
+	const bool ReadVersion(const uint8_t age, uint8_t* target)
+	{
+		uint8_t corrections = 0;
+
+		return (age < (uint8_t)WearLevelOption)
+			&& ReadCounterSlot(GetVersionCounter(GetCurrentCounter(), age), target, corrections);
+	}
+
+	/// <summary>
+	/// Reads the next valid version, newest first.
+	/// Skips never written or invalid slots.
+	/// for (uint8_t age = 0; unit.ReadNextVersion(age, target); age++)
+	/// </summary>
+	/// <param name="age">Version age to start from, set to the found version's age.</param>
+	/// <param name="target">Target array.</param>
+	/// <returns>True if a valid version was found.</returns>
+	const bool ReadNextVersion(uint8_t& age, uint8_t* target)
+	{
+		const uint8_t counter = GetCurrentCounter();
+		uint8_t corrections = 0;
+
+		for (; age < (uint8_t)WearLevelOption; age++)
 		{
-			target[i] = EmbeddedEEPROM::ReadBlock(address + offset + i);
+			if (ReadCounterSlot(GetVersionCounter(counter, age), target, corrections))
+			{
+				return true;
+			}
 		}
 
-		return Crc.GetCrc(target, DataSize, counter) == EmbeddedEEPROM::ReadBlock(address + offset + DataSize);
+		return false;
 	}
 
+	/// <summary>
+	/// Reads the last committed slot, without locking out a concurrent writer.
+	/// Retries if a write was committed while reading.
+	/// </summary>
+	/// <param name="target">Target array.</param>
+	/// <returns>True if CRC matches.</returns>
+	const bool ReadCommitted(uint8_t* target)
+	{
+		uint8_t counter = GetCurrentCounter();
+		uint8_t corrections = 0;
+
+		for (uint8_t attempt = 0; attempt < (uint8_t)WearLevelOption; attempt++)
+		{
+			const bool valid = ReadCounterSlot(counter, target, corrections);
+			const uint8_t committed = GetCurrentCounter();
+
+			if (valid && committed == counter)
+			{
+				return true;
+			}
+			counter = committed;
+		}
+
+		return false;
+	}
 
 	/// <summary>
 	/// Writes the declared DataSize from source array.
+	/// The next slot is written first, then committed by incrementing the counter.
+	/// Until then, readers and a reset keep the previous data.
 	/// </summary>
 	/// <param name="source">Source array.</param>
 	void WriteData(const uint8_t* source)
 	{
-		const uint8_t counter = IncrementCounter();
-		const uint16_t offset = (uint16_t)GetCounterSize() + ((uint16_t)counter * EmbeddedStorage::GetStorageSize(DataSize));
+		const uint8_t counter = GetNextCounter();
+		const StorageAddress slotAddress = GetSlotAddress(counter);
+		const uint8_t crc = StorageEngine::WriteSlot(slotAddress, source, DataSize, Key, counter);
 
-		for (uint16_t i = 0; i < DataSize; i++)
+		if (Correction == ErrorCorrection::Secded)
 		{
-			EmbeddedEEPROM::WriteBlock(address + offset + i, source[i]);
+			EmbeddedEcc::WriteParity(slotAddress, source, DataSize, crc);
 		}
 
-		EmbeddedEEPROM::WriteBlock(address + offset + DataSize, Crc.GetCrc(source, DataSize, counter));
+		CommitCounter(counter);
 	}
 
-	void WriteByte(const uint16_t offset, const uint8_t value)
+	void WriteByte(const StorageAddress offset, const uint8_t value)
 	{
 		EmbeddedEEPROM::WriteBlock(address + offset, value);
 	}
 
-	const uint8_t ReadByte(const uint16_t offset)
+	const uint8_t ReadByte(const StorageAddress offset)
 	{
 		return EmbeddedEEPROM::ReadBlock(address + offset);
 	}
 
 private:
+	const bool ReadCounterSlot(const uint8_t counter, uint8_t* target, uint8_t& corrections)
+	{
+		const StorageAddress slotAddress = GetSlotAddress(counter);
+
+		corrections = 0;
+
+		return StorageEngine::ReadSlot(slotAddress, target, DataSize, Key, counter)
+			|| (Correction == ErrorCorrection::Secded
+				&& StorageEngine::CorrectSlot(slotAddress, target, DataSize, Key, counter, corrections));
+	}
+
+	/// <summary>
+	/// Slot counter of the version age writes before current.
+	/// </summary>
+	static constexpr uint8_t GetVersionCounter(const uint8_t current, const uint8_t age)
+	{
+		return (uint8_t)((current + (uint8_t)WearLevelOption - age) % (uint8_t)WearLevelOption);
+	}
+
 	/// <summary>
 	/// Ensure the current counter in this Unit is according to spec.
 	/// </summary>
 	void Initialize()
 	{
-		if (!ValidateCounterMask())
+		if (!StorageEngine::ValidateCounter(address, GetCounterSize()))
 		{
 			ResetCounter();
 		}
 	}
 
 protected:
-	static constexpr uint8_t Uint8Min(const uint8_t a, const uint8_t b)
+	const uint8_t GetCurrentCounter()
+	{
+		return StorageEngine::GetCounter(address, GetCounterSize(), (uint8_t)WearLevelOption);
+	}
+
+	/// <summary>
+	/// Increments the counter in a flash compatible way.
+	/// From 0 to WearLevelOption - 1.
+	/// </summary>
+	/// <returns>Current Counter</returns>
+	const uint8_t IncrementCounter()
+	{
+		return StorageEngine::IncrementCounter(address, GetCounterSize(), (uint8_t)WearLevelOption);
+	}
+
+	/// <summary>
+	/// Counter of the next slot to write, committed after the write with CommitCounter().
+	/// </summary>
+	const uint8_t GetNextCounter()
+	{
+		return StorageEngine::GetNextCounter(GetCurrentCounter(), (uint8_t)WearLevelOption);
+	}
+
+	void CommitCounter(const uint8_t counter)
+	{
+		StorageEngine::CommitCounter(address, GetCounterSize(), counter);
+	}
+
+	const uint64_t GetCounterMask()
+	{
+		return StorageEngine::GetCounterMask(address, GetCounterSize());
+	}
+
+	/// <summary>
+	/// EEPROM address of the Data/CRC slot for the given counter.
+	/// </summary>
+	/// <param name="counter"></param>
+	/// <returns></returns>
+	static constexpr StorageAddress GetSlotAddress(const uint8_t counter)
 	{
-		return ((a <= b) * a) | ((b < a) * b);
+		return address + (StorageAddress)GetCounterSize() + ((StorageAddress)counter * EmbeddedStorage::GetStorageSize(DataSize, NoWearLevel::x1, Correction));
 	}
 };
 #endif
\ No newline at end of file
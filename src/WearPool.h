@@ -0,0 +1,305 @@
+#ifndef _WEAR_POOL_
+#define _WEAR_POOL_
+
+#include "EmbeddedStorageBase\EmbeddedEEPROM.h"
+#include "EmbeddedStorageBase\StorageEngine.h"
+#include <EmbeddedStorage.h>
+
+/// <summary>
+/// Dynamic wear pool, shared by several owners, i.e. over the EEPROM left unallocated by the layout.
+/// Slots are not assigned at compile time: each write takes the next free slot of the ring,
+///  so owners get slots in proportion to their write rate.
+/// The hottest owner is levelled over every slot not holding another owner's current data.
+/// Ownership is stored in each slot's header, the current slot of each owner is found on Begin().
+/// ||Owner|Sequence|Data...|CRC|| x GetSlotCount()
+/// A slot is only written once it holds no owner's current data, a reset during a write keeps the previous data.
+/// Current slots older than RefreshAge writes are copied forward, so sequences never wrap ambiguously.
+/// Unlike most units, each owner's current slot and sequence are kept in RAM, 4 bytes per owner plus 4.
+/// </summary>
+/// <param name="size">Pool size in bytes, i.e. the unallocated tail.</param>
+/// <param name="DataSize">Data size in bytes, shared by all owners.</param>
+/// <param name="OwnerCount">Number of owners, from 1 to 254.</param>
+/// <param name="Key">Storage cryptographic salt key.
+///  Changing the key invalidates any previous data.</param>
+template<const StorageAddress address,
+	const StorageAddress size,
+	const uint16_t DataSize,
+	const uint8_t OwnerCount,
+	const uint32_t Key = DataSize>
+class WearPool
+{
+private:
+	static constexpr uint16_t SequenceOffset = 1;
+	static constexpr uint16_t DataOffset = SequenceOffset + sizeof(uint16_t);
+	static constexpr uint16_t RecordSize = DataOffset + DataSize;
+	static constexpr uint16_t RecordStride = RecordSize + 1;
+
+	static constexpr uint16_t SlotCount = size / RecordStride;
+	static constexpr uint16_t NoSlot = UINT16_MAX;
+	static constexpr uint16_t RefreshAge = 0x4000;
+
+	static_assert(OwnerCount > 0 && OwnerCount < UINT8_MAX, "OwnerCount must be from 1 to 254.");
+	static_assert((size / RecordStride) > OwnerCount, "Pool must have more slots than owners.");
+	static_assert((size / RecordStride) < RefreshAge, "Pool must have fewer than 16384 slots.");
+	static_assert(EmbeddedStorage::Fits(address, (uint32_t)SlotCount * RecordStride), "Pool exceeds the StorageAddress range, enable EEPROM_ADDRESS_32.");
+
+	struct OwnerState
+	{
+		uint16_t Slot;
+		uint16_t Sequence;
+	};
+
+private:
+	OwnerState Owners[OwnerCount]{};
+	uint16_t Next = 0;
+	uint16_t Sequence = 0;
+
+public:
+	static constexpr StorageAddress Address()
+	{
+		return address;
+	}
+
+	static constexpr StorageAddress Size()
+	{
+		return (StorageAddress)SlotCount * RecordStride;
+	}
+
+	static constexpr uint16_t GetSlotCount()
+	{
+		return SlotCount;
+	}
+
+	static constexpr uint8_t GetOwnerCount()
+	{
+		return OwnerCount;
+	}
+
+public:
+	/// <summary>
+	/// Finds each owner's current slot and the next free slot, with one pass over the pool.
+	/// Construction has no side effects, call once from setup().
+	/// </summary>
+	void Begin()
+	{
+		EEPROM.begin();
+
+		bool found = false;
+		uint16_t newest = 0;
+		uint16_t newestSlot = 0;
+
+		for (uint8_t i = 0; i < OwnerCount; i++)
+		{
+			Owners[i].Slot = NoSlot;
+		}
+
+		for (uint16_t slot = 0; slot < SlotCount; slot++)
+		{
+			const StorageAddress slotAddress = GetSlotAddress(slot);
+			const uint8_t owner = EmbeddedEEPROM::ReadBlock(slotAddress);
+
+			if (owner < OwnerCount
+				&& StorageEngine::VerifySlot(slotAddress, RecordSize, Key, 0))
+			{
+				const uint16_t sequence = ReadSequence(slotAddress);
+
+				if (Owners[owner].Slot == NoSlot
+					|| IsNewer(sequence, Owners[owner].Sequence))
+				{
+					Owners[owner] = OwnerState{ slot, sequence };
+				}
+
+				if (!found || IsNewer(sequence, newest))
+				{
+					found = true;
+					newest = sequence;
+					newestSlot = slot;
+				}
+			}
+		}
+
+		Next = found ? GetNextSlot(newestSlot) : 0;
+		Sequence = found ? (uint16_t)(newest + 1) : 0;
+	}
+
+	/// <summary>
+	/// Reads owner's current data into target array.
+	/// </summary>
+	/// <param name="owner">Owner index.</param>
+	/// <param name="target">Target array.</param>
+	/// <returns>True if owner has valid data.</returns>
+	const bool ReadData(const uint8_t owner, uint8_t* target)
+	{
+		uint8_t record[RecordSize];
+
+		if (Owners[owner].Slot == NoSlot
+			|| !StorageEngine::ReadSlot(GetSlotAddress(Owners[owner].Slot), record, RecordSize, Key, 0))
+		{
+			return false;
+		}
+
+		for (uint16_t i = 0; i < DataSize; i++)
+		{
+			target[i] = record[DataOffset + i];
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Writes owner's data to the next free slot.
+	/// Any owner's data older than RefreshAge writes is copied forward first.
+	/// </summary>
+	/// <param name="owner">Owner index.</param>
+	/// <param name="source">Source array.</param>
+	void WriteData(const uint8_t owner, const uint8_t* source)
+	{
+		uint8_t record[RecordSize];
+
+		for (uint8_t i = 0; i < OwnerCount; i++)
+		{
+			if (i != owner
+				&& Owners[i].Slot != NoSlot
+				&& (uint16_t)(Sequence - Owners[i].Sequence) >= RefreshAge
+				&& StorageEngine::ReadSlot(GetSlotAddress(Owners[i].Slot), record, RecordSize, Key, 0))
+			{
+				WriteRecord(i, record);
+			}
+		}
+
+		for (uint16_t i = 0; i < DataSize; i++)
+		{
+			record[DataOffset + i] = source[i];
+		}
+
+		WriteRecord(owner, record);
+	}
+
+	/// <summary>
+	/// Number of valid slots holding owner's data, current and previous.
+	/// Grows with the owner's share of the writes, for diagnostics.
+	/// </summary>
+	const uint16_t GetOwnedSlots(const uint8_t owner)
+	{
+		uint16_t count = 0;
+
+		for (uint16_t slot = 0; slot < SlotCount; slot++)
+		{
+			if (EmbeddedEEPROM::ReadBlock(GetSlotAddress(slot)) == owner
+				&& StorageEngine::VerifySlot(GetSlotAddress(slot), RecordSize, Key, 0))
+			{
+				count++;
+			}
+		}
+
+		return count;
+	}
+
+private:
+	/// <summary>
+	/// Writes the record's Data to the next slot that holds no owner's current data.
+	/// Owner and Sequence are set here.
+	/// </summary>
+	void WriteRecord(const uint8_t owner, uint8_t* record)
+	{
+		while (IsCurrent(Next))
+		{
+			Next = GetNextSlot(Next);
+		}
+
+		record[0] = owner;
+		record[SequenceOffset] = Sequence & UINT8_MAX;
+		record[SequenceOffset + 1] = Sequence >> 8;
+
+		StorageEngine::WriteSlot(GetSlotAddress(Next), record, RecordSize, Key, 0);
+
+		Owners[owner] = OwnerState{ Next, Sequence };
+		Next = GetNextSlot(Next);
+		Sequence++;
+	}
+
+	const bool IsCurrent(const uint16_t slot) const
+	{
+		for (uint8_t i = 0; i < OwnerCount; i++)
+		{
+			if (Owners[i].Slot == slot)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	static const bool IsNewer(const uint16_t sequence, const uint16_t reference)
+	{
+		return (int16_t)(sequence - reference) > 0;
+	}
+
+	static const uint16_t ReadSequence(const StorageAddress slotAddress)
+	{
+		return ((uint16_t)EmbeddedEEPROM::ReadBlock(slotAddress + SequenceOffset + 1) << 8)
+			| EmbeddedEEPROM::ReadBlock(slotAddress + SequenceOffset);
+	}
+
+	static constexpr uint16_t GetNextSlot(const uint16_t slot)
+	{
+		return ((slot + 1) >= SlotCount) ? 0 : (slot + 1);
+	}
+
+	static constexpr StorageAddress GetSlotAddress(const uint16_t slot)
+	{
+		return address + ((StorageAddress)slot * RecordStride);
+	}
+};
+
+/// <summary>
+/// WearPool over all the space a layout leaves unallocated on the device.
+/// </summary>
+/// <typeparam name="LayoutType">TemplateStorageAttributor or TemplateStorageDispatcher.</typeparam>
+/// <typeparam name="DeviceProfile">Device traits, i.e. DeviceProfileATmega328P.</typeparam>
+template<typename LayoutType,
+	typename DeviceProfile,
+	const uint16_t DataSize,
+	const uint8_t OwnerCount,
+	const uint32_t Key = DataSize>
+using TemplateWearPool = WearPool<LayoutType::GetUsed(), DeviceProfile::Capacity - LayoutType::GetUsed(), DataSize, OwnerCount, Key>;
+
+/// <summary>
+/// Typed facade for one owner of a WearPool.
+/// </summary>
+/// <param name="owner">Owner index.</param>
+template<const uint8_t owner>
+class WearPoolUnit
+{
+public:
+	static constexpr uint8_t Owner()
+	{
+		return owner;
+	}
+
+public:
+	/// <summary>
+	/// Reads the owner's current data into target array.
+	/// </summary>
+	/// <returns>True if CRC matches.</returns>
+	template<typename PoolType>
+	const bool ReadData(PoolType& pool, uint8_t* target)
+	{
+		static_assert(owner < PoolType::GetOwnerCount(), "Owner index exceeds the pool's OwnerCount.");
+
+		return pool.ReadData(owner, target);
+	}
+
+	/// <summary>
+	/// Writes the owner's data to the pool's next free slot.
+	/// </summary>
+	template<typename PoolType>
+	void WriteData(PoolType& pool, const uint8_t* source)
+	{
+		static_assert(owner < PoolType::GetOwnerCount(), "Owner index exceeds the pool's OwnerCount.");
+
+		pool.WriteData(owner, source);
+	}
+};
+#endif